@@ -4,7 +4,7 @@
 #
 #-------------------------------------------------
 
-QT       += core gui uitools
+QT       += core gui uitools network
 CONFIG += c++14
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
@@ -12,6 +12,8 @@ greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 TARGET = Qttitude
 TEMPLATE = app
 
+INCLUDEPATH += stylesheetclient
+
 
 SOURCES += main.cpp\
         mainwindow.cpp \
@@ -21,6 +23,7 @@ SOURCES += main.cpp\
     stylesheeteditorwidget.cpp \
     texteditor.cpp \
     colorschemegenerator.cpp \
+    imagesampler.cpp \
     workspace.cpp \
     dialogcolorspec.cpp \
     globals.cpp \
@@ -29,10 +32,21 @@ SOURCES += main.cpp\
     dialogtexteditor.cpp \
     project.cpp \
     codegen.cpp \
-    dialogpagecreator.cpp
+    dialogpagecreator.cpp \
+    stylesheetexpander.cpp \
+    stylesheetpagecache.cpp \
+    stylesheetdependencyindex.cpp \
+    previewscheduler.cpp \
+    stylesheetgenerationtask.cpp \
+    qssparser.cpp \
+    qssruleindex.cpp \
+    qssminifier.cpp \
+    stylesheetbundle.cpp \
+    stylesheetserver.cpp
 
 HEADERS  += mainwindow.h \
     coloreditorwidget.h \
+    imagesampler.h \
     highlighter.h \
     stylesheeteditoritemdelegate.h \
     stylesheeteditorwidget.h \
@@ -47,7 +61,19 @@ HEADERS  += mainwindow.h \
     dialogtexteditor.h \
     project.h \
     codegen.h \
-    dialogpagecreator.h
+    dialogpagecreator.h \
+    stylesheetexpander.h \
+    stylesheetpagecache.h \
+    stylesheetdependencyindex.h \
+    previewscheduler.h \
+    stylesheetgenerationtask.h \
+    qssparser.h \
+    qssruleindex.h \
+    qssminifier.h \
+    stylesheetbundle.h \
+    stylesheetclient/stylesheetprotocol.h \
+    stylesheetclient/stylesheetbundlereader.h \
+    stylesheetserver.h
 
 FORMS    += mainwindow.ui \
     stylesheeteditorwidget.ui \
@@ -39,6 +39,9 @@
 #include <QObject>
 #include <QColor>
 
+// Local Libraries
+#include "imagesampler.h"
+
 
 class ColorSchemeGenerator : public QObject
 {
@@ -49,9 +52,12 @@ public:
     enum SchemeOrder{Count, HSV, HVS, SVH, SHV, VHS, VSH};
 
     /** This member function generates a color scheme from an image. The function returns num_colors number of colors.
+     * The colors are clustered from num_samples pixels chosen by the sampling mode, see ImageSampler. A seed other
+     * than 0 makes the samples deterministic.
      */
     static QMap<int, QColor> generate(const QString& filename, const int& num_colors = 10,
-                                      const int& num_samples = 1000, const int& color_ordering = HSV);
+                                      const int& num_samples = 1000, const int& color_ordering = HSV,
+                                      const int& sampling = ImageSampler::Stratified, const unsigned int& seed = 0);
 
     static QMap<int, QColor> generateRandom(const int& num_colors,
                                             const int& min_hue = 0, const int& max_hue = 255,
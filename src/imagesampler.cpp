@@ -0,0 +1,216 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 George Sithole
+** Contact: http://www.geovariant.com/qttitude/
+**
+** This is free software distributed under the terms of the GNU General Public License, GPL v3.
+**
+** "Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are
+** met:
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in
+**     the documentation and/or other materials provided with the
+**     distribution.
+**   * Neither the name of Qttitude nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+**
+
+// C/C++ Libraries
+#include <cmath>
+
+// Qt Libraries
+#include <QtMath>
+
+// Local Libraries
+#include "imagesampler.h"
+
+
+std::vector<std::array<float, 3>> ImageSampler::sample(const QImage& image, const int& num_samples, const int& mode,
+                                                       const unsigned int& seed)
+{
+    if(image.isNull())
+        return std::vector<std::array<float, 3>>();
+
+    if(mode == Full || num_samples <= 0 || qint64(num_samples) >= qint64(image.width()) * image.height())
+        return ImageSampler::sampleAll(image);
+
+    std::mt19937 generator(seed != 0 ? seed : std::random_device()());
+
+    std::vector<QPoint> points;
+    switch(mode)
+    {
+    case UniformRandom: points = ImageSampler::uniformRandom(image.size(), num_samples, generator); break;
+    case PoissonDisk:   points = ImageSampler::poissonDisk(image.size(), num_samples, generator); break;
+    default:            points = ImageSampler::stratified(image.size(), num_samples, generator); break;
+    }
+
+    // the pixels of 32 bit images are read from the scanlines, the others are converted one pixel at a time
+    bool direct = image.format() == QImage::Format_RGB32 || image.format() == QImage::Format_ARGB32;
+    std::vector<std::array<float, 3>> data(points.size());
+    for(size_t i = 0; i < points.size(); ++i)
+    {
+        const QPoint& p = points[i];
+        QRgb rgb = direct ? ((const QRgb*)image.constScanLine(p.y()))[p.x()] : image.pixel(p);
+        data[i] = {float(qRed(rgb)), float(qGreen(rgb)), float(qBlue(rgb))};
+    }
+    return data;
+}
+
+std::vector<std::array<float, 3>> ImageSampler::sampleAll(const QImage& image)
+{
+    // convert the image once, so the pixels are read from the scanlines without a conversion per pixel
+    QImage rgb_image = image.convertToFormat(QImage::Format_RGB32);
+
+    // read the pixels row by row, in the order they are in memory
+    const int width = rgb_image.width();
+    const int height = rgb_image.height();
+    std::vector<std::array<float, 3>> data(size_t(width) * size_t(height));
+    auto sample = data.begin();
+    for(int y = 0; y < height; ++y)
+    {
+        const QRgb* line = (const QRgb*)rgb_image.constScanLine(y);
+        for(int x = 0; x < width; ++x, ++sample)
+        {
+            QRgb rgb = line[x];
+            *sample = {float(qRed(rgb)), float(qGreen(rgb)), float(qBlue(rgb))};
+        }
+    }
+    return data;
+}
+
+std::vector<QPoint> ImageSampler::uniformRandom(const QSize& size, const int& num_samples, std::mt19937& generator)
+{
+    std::uniform_int_distribution<int> x_distribution(0, size.width() - 1);
+    std::uniform_int_distribution<int> y_distribution(0, size.height() - 1);
+
+    std::vector<QPoint> points(size_t(num_samples));
+    for(QPoint& p: points)
+    {
+        int x = x_distribution(generator);
+        p = QPoint(x, y_distribution(generator));
+    }
+    return points;
+}
+
+std::vector<QPoint> ImageSampler::stratified(const QSize& size, const int& num_samples, std::mt19937& generator)
+{
+    // divide the image into a grid of cells with about the aspect ratio of the image, one sample per cell
+    const int width = size.width();
+    const int height = size.height();
+    int columns = qBound(1, int(std::lround(std::sqrt(double(num_samples) * width / height))), width);
+    int rows = qBound(1, num_samples / columns, height);
+
+    // a random pixel of each cell, visited row by row
+    std::vector<QPoint> points;
+    points.reserve(size_t(columns) * size_t(rows));
+    for(int row = 0; row < rows; ++row)
+    {
+        int y0 = int(qint64(row) * height / rows);
+        int y1 = int(qint64(row + 1) * height / rows);
+        std::uniform_int_distribution<int> y_distribution(y0, y1 - 1);
+        for(int column = 0; column < columns; ++column)
+        {
+            int x0 = int(qint64(column) * width / columns);
+            int x1 = int(qint64(column + 1) * width / columns);
+            int x = std::uniform_int_distribution<int>(x0, x1 - 1)(generator);
+            points.push_back(QPoint(x, y_distribution(generator)));
+        }
+    }
+    return points;
+}
+
+std::vector<QPoint> ImageSampler::poissonDisk(const QSize& size, const int& num_samples, std::mt19937& generator)
+{
+    // Bridson's algorithm. the samples are at least the spacing of a grid of num_samples cells apart, and a background
+    // grid with at most one sample per cell finds the neighbours of a candidate
+    const int width = size.width();
+    const int height = size.height();
+    const double radius = qMax(1.0, std::sqrt(double(width) * height / num_samples));
+    const double cell_size = radius / std::sqrt(2.0);
+    const int grid_width = int(std::ceil(width / cell_size));
+    const int grid_height = int(std::ceil(height / cell_size));
+    std::vector<int> grid(size_t(grid_width) * size_t(grid_height), -1);
+
+    std::vector<QPointF> samples;
+    std::vector<int> active;
+    samples.reserve(size_t(num_samples));
+
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    auto add = [&](const QPointF& p)
+    {
+        int gx = int(p.x() / cell_size);
+        int gy = int(p.y() / cell_size);
+        grid[size_t(gy) * size_t(grid_width) + size_t(gx)] = int(samples.size());
+        active.push_back(int(samples.size()));
+        samples.push_back(p);
+    };
+    add(QPointF(unit(generator) * width, unit(generator) * height));
+
+    // try candidates around a random active sample, and retire the sample when none fits
+    const int candidates = 30;
+    while(!active.empty() && int(samples.size()) < num_samples)
+    {
+        size_t a = std::uniform_int_distribution<size_t>(0, active.size() - 1)(generator);
+        QPointF center = samples[size_t(active[a])];
+
+        bool found = false;
+        for(int c = 0; c < candidates && !found; ++c)
+        {
+            double angle = 2.0 * M_PI * unit(generator);
+            double distance = radius * (1.0 + unit(generator));
+            QPointF p(center.x() + distance * std::cos(angle), center.y() + distance * std::sin(angle));
+            if(p.x() < 0 || p.y() < 0 || p.x() >= width || p.y() >= height)
+                continue;
+
+            // a sample closer than the radius is in one of the 5x5 cells around the candidate
+            int gx = int(p.x() / cell_size);
+            int gy = int(p.y() / cell_size);
+            bool fits = true;
+            for(int y = qMax(0, gy - 2); y <= qMin(grid_height - 1, gy + 2) && fits; ++y)
+            {
+                for(int x = qMax(0, gx - 2); x <= qMin(grid_width - 1, gx + 2) && fits; ++x)
+                {
+                    int s = grid[size_t(y) * size_t(grid_width) + size_t(x)];
+                    if(s >= 0)
+                    {
+                        QPointF d = samples[size_t(s)] - p;
+                        fits = d.x() * d.x() + d.y() * d.y() >= radius * radius;
+                    }
+                }
+            }
+
+            if(fits)
+            {
+                add(p);
+                found = true;
+            }
+        }
+
+        if(!found)
+        {
+            active[a] = active.back();
+            active.pop_back();
+        }
+    }
+
+    std::vector<QPoint> points(samples.size());
+    for(size_t i = 0; i < samples.size(); ++i)
+        points[i] = QPoint(int(samples[i].x()), int(samples[i].y()));
+    return points;
+}
@@ -0,0 +1,75 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 George Sithole
+** Contact: http://www.geovariant.com/qttitude/
+**
+** This is free software distributed under the terms of the GNU General Public License, GPL v3.
+**
+** "Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are
+** met:
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in
+**     the documentation and/or other materials provided with the
+**     distribution.
+**   * Neither the name of Qttitude nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+**
+
+#ifndef IMAGESAMPLER_H
+#define IMAGESAMPLER_H
+
+// C/C++ Libraries
+#include <array>
+#include <random>
+#include <vector>
+
+// Qt Libraries
+#include <QImage>
+#include <QPoint>
+
+
+/**
+ * @brief The ImageSampler class samples the colors of an image for the color scheme generation.
+ *
+ * The samples are read from the scanlines of the decoded image, without scaling it, so the time taken is proportional
+ * to the number of samples rather than to the number of pixels. A seed other than 0 makes the samples deterministic.
+ * The whole image is read if it has no more pixels than the samples requested.
+ */
+class ImageSampler
+{
+public:
+    enum Mode{Full, UniformRandom, Stratified, PoissonDisk};
+
+    /** This member function returns the RGB colors of about num_samples pixels of the image. The Poisson-disk samples
+     * may be fewer, since no two of them are closer than the spacing that gives num_samples samples on a grid.
+     */
+    static std::vector<std::array<float, 3>> sample(const QImage& image, const int& num_samples,
+                                                    const int& mode = Stratified, const unsigned int& seed = 0);
+
+protected:
+    static std::vector<std::array<float, 3>> sampleAll(const QImage& image);
+
+    static std::vector<QPoint> uniformRandom(const QSize& size, const int& num_samples, std::mt19937& generator);
+
+    static std::vector<QPoint> stratified(const QSize& size, const int& num_samples, std::mt19937& generator);
+
+    static std::vector<QPoint> poissonDisk(const QSize& size, const int& num_samples, std::mt19937& generator);
+};
+
+#endif // IMAGESAMPLER_H
@@ -57,6 +57,9 @@
 #include <QMessageBox>
 #include <QDesktopServices>
 #include <QVector>
+#include <QTimer>
+#include <QLabel>
+#include <QSet>
 
 
 // Local Libraries
@@ -67,6 +70,7 @@
 #include "workspace.h"
 #include "project.h"
 #include "codegen.h"
+#include "stylesheetserver.h"
 
 
 MainWindow::MainWindow(QWidget *parent) :
@@ -83,6 +87,14 @@ MainWindow::MainWindow(QWidget *parent) :
     // create the project object
     this->m_project = new Project(this);
 
+    // initialize the applied style sheet
+    this->m_style_sheet_hash = 0;
+
+    // the whole style sheet is applied once the partial preview has settled
+    this->m_settle_timer = new QTimer(this);
+    this->m_settle_timer->setSingleShot(true);
+    this->m_settle_timer->setInterval(500);
+
     // add style sheet widget
     QGridLayout* layout = new QGridLayout(ui->widget);
     layout->setMargin(0);
@@ -92,6 +104,15 @@ MainWindow::MainWindow(QWidget *parent) :
     this->m_se_widget->setMainWindow(nullptr);
     layout->addWidget(this->m_se_widget, 0, 0, 1, 1);
 
+    // publish the style sheet to the running applications
+    this->m_ss_server = new StyleSheetServer(this);
+    this->m_clients_label = new QLabel(this);
+    ui->statusBar->addPermanentWidget(this->m_clients_label);
+    this->updateClientsStatus();
+    this->m_latency_label = new QLabel(this);
+    ui->statusBar->addPermanentWidget(this->m_latency_label);
+    this->updateLatencyStatus();
+
     // read settings
     this->readSettings();
 
@@ -122,13 +143,23 @@ MainWindow::MainWindow(QWidget *parent) :
     ui->actionLive_Preview->setChecked(true);
     this->m_se_widget->setLivePreview(ui->actionLive_Preview->isChecked());
 
+    // initialise the partial preview
+    ui->actionPartial_Preview->setChecked(true);
+
     // initialise the outputs
     ui->actionCpp->setChecked(true);
     ui->actionPython->setChecked(true);
 
     // setup connections
+    // the slots run in connection order, so the running applications get the style sheet before the preview is polished
+    connect(this->m_se_widget, SIGNAL(styleSheetReady(QString)), this, SLOT(publishStyleSheet(QString)));
     connect(this->m_se_widget, SIGNAL(styleSheetReady(QString)), this, SLOT(applyStyleSheet(QString)));
+    connect(this->m_se_widget, SIGNAL(styleSheetWarning(QString)), ui->statusBar, SLOT(showMessage(QString)));
     connect(ui->actionLive_Preview, SIGNAL(triggered(bool)), this->m_se_widget, SLOT(setLivePreview(bool)));
+    connect(this->m_settle_timer, SIGNAL(timeout()), this, SLOT(settleStyleSheets()));
+    connect(this->m_ss_server, SIGNAL(clientsChanged()), this, SLOT(updateClientsStatus()));
+    connect(this->m_ss_server, SIGNAL(latenciesChanged()), this, SLOT(updateLatencyStatus()));
+    connect(this->m_ss_server, SIGNAL(serverError(QString)), ui->statusBar, SLOT(showMessage(QString)));
 }
 
 MainWindow::~MainWindow()
@@ -145,7 +176,7 @@ void MainWindow::keyPressEvent(QKeyEvent *event)
         case Qt::Key_O: this->openStyleSheetProject(); break;
         case Qt::Key_S: this->saveStyleSheetProject(this->m_project->projectFilename()); break; // save
         case Qt::Key_A: this->saveStyleSheetProject(); break; // save as
-        case Qt::Key_E: this->m_se_widget->saveStyleSheet(); break; // export
+        case Qt::Key_E: this->on_action_Export_triggered(); break; // export
         case Qt::Key_X: this->close(); break; // exit
         default: break;
         }
@@ -170,6 +201,10 @@ void MainWindow::readSettings()
     this->resize(settings.value("size", QSize(400, 400)).toSize());
     this->move(settings.value("pos", QPoint(200, 200)).toPoint());
     settings.endGroup();
+
+    settings.beginGroup("Preview");
+    this->m_se_widget->setPreviewLatency(settings.value("latency", 100).toInt());
+    settings.endGroup();
 }
 
 void MainWindow::closeEvent(QCloseEvent *event)
@@ -239,6 +274,12 @@ bool MainWindow::addUiFile(const QString& filename, const bool& visible)
 //        this->m_files_model->appendRow({item0, item1});
         this->m_files_model->appendRow(item0);
 
+        // initialise the dockwidgets style before it is shown, since showing it applies the current style sheet
+        // and records it as applied
+        dockwidget->setStyleSheet(" ");
+        widget->setStyleSheet(" ");
+        this->indexDockWidget(dockwidget);
+
         // show or hide the dockwidget
         if (visible) {
             dockwidget->show();
@@ -247,10 +288,6 @@ bool MainWindow::addUiFile(const QString& filename, const bool& visible)
             dockwidget->hide();
         }
 
-        // initialise the dockwidgets style
-        dockwidget->setStyleSheet(" ");
-        widget->setStyleSheet(" ");
-
         // set the widgets connections
 //            connect(dockwidget, SIGNAL(destroyed(QObject*)), this, SLOT(widgetDestroyed(QObject*)));
 
@@ -277,6 +314,7 @@ void MainWindow::removeUiFile(const QString& ui_filepath)
 {
     // remove the ui widget from the widgets map and then delete the ui widget
     QDockWidget* dockwidget = this->m_ui_dockwidgets_map.take(ui_filepath);
+    this->m_ui_styles.remove(dockwidget);
     dockwidget->hide(); // always hide the dockwidget before removing it
     dockwidget->deleteLater(); // delete the widget
 
@@ -316,6 +354,8 @@ void MainWindow::destroyAllDockWidgets()
         dw->deleteLater();
     }
     this->m_ui_dockwidgets_map.clear();
+    this->m_ui_styles.clear();
+    this->m_settle_timer->stop();
     this->m_files_model->clear();
 }
 
@@ -490,6 +530,12 @@ bool MainWindow::eventFilter(QObject *obj, QEvent *event)
             processed = true;
         }
     }
+    else if (event->type() == QEvent::Show and isDockWidget) {
+        // apply the style sheet that was deferred while the dockwidget was hidden
+        QDockWidget* dockwidget = qobject_cast<QDockWidget *>(obj);
+        if(dockwidget && dockwidget->widget() && !this->m_style_sheet.isNull())
+            this->updateDockWidgetStyleSheet(dockwidget);
+    }
     else if (event->type() == QEvent::Hide and isDockWidget) {
         if(obj != nullptr) // calling deleteLater on a dockwidget triggers the Hide event of the dockwidget. this check ensures that the dockwidget exists before it is used
         {
@@ -553,10 +599,241 @@ void MainWindow::applyStyleSheet(const QString& style_sheet)
     this->m_project->setIsSaved(false);
     this->setWindowTitle(this->m_workspace->appWindowTitle(this->m_project->projectFilename(), false));
 
-    // apply the stylesheet
+    // apply the stylesheet. in the partial preview only the widgets matching the changed rules are updated,
+    // and the whole style sheet is applied when the editing has settled
+    this->setStyleSheetText(style_sheet);
+    bool partial = false;
+    foreach(QDockWidget* dw, this->m_ui_dockwidgets_map)
+    {
+        if(ui->actionPartial_Preview->isChecked() && this->updateDockWidgetStyleSheetPartially(dw))
+            partial = true;
+        else
+            this->updateDockWidgetStyleSheet(dw);
+    }
+
+    if(partial)
+        this->m_settle_timer->start();
+}
+
+void MainWindow::settleStyleSheets()
+{
     foreach(QDockWidget* dw, this->m_ui_dockwidgets_map)
     {
-        dw->widget()->setStyleSheet(style_sheet);
+        this->updateDockWidgetStyleSheet(dw);
+    }
+}
+
+void MainWindow::publishStyleSheet(const QString& style_sheet)
+{
+    // the latencies of the running applications are measured from the edit
+    this->m_ss_server->publishStyleSheet(style_sheet, this->m_se_widget->styleSheetEditTime());
+}
+
+void MainWindow::updateClientsStatus()
+{
+    // show the number of running applications that have applied the latest style sheet
+    QList<StyleSheetClientInfo> clients = this->m_ss_server->clients();
+    QStringList lines;
+    int current = 0;
+    for(const StyleSheetClientInfo& client: clients)
+    {
+        if(client.sequence == this->m_ss_server->sequence())
+            ++current;
+        lines << QString("%0 (%1): revision %2 applied in %3 ms, %4 objects")
+                 .arg(client.name.isEmpty() ? QString("Unknown") : client.name)
+                 .arg(client.pid).arg(client.sequence).arg(client.apply_duration / 1000.0, 0, 'f', 1)
+                 .arg(client.objects.count());
+    }
+
+    this->m_clients_label->setText(QString("Clients: %0/%1 up to date").arg(current).arg(clients.count()));
+    this->m_clients_label->setToolTip(QString("Latest revision %0\n").arg(this->m_ss_server->sequence()) + lines.join("\n"));
+    this->m_clients_label->setVisible(!clients.isEmpty());
+}
+
+void MainWindow::updateLatencyStatus()
+{
+    // show the percentiles of the recent latencies from an edit to the first paint in the running applications
+    StyleSheetLatency p50 = this->m_ss_server->latencyPercentile(0.5);
+    StyleSheetLatency p90 = this->m_ss_server->latencyPercentile(0.9);
+    StyleSheetLatency p99 = this->m_ss_server->latencyPercentile(0.99);
+
+    QString line("%0: p50 %1 ms, p90 %2 ms, p99 %3 ms");
+    this->m_latency_label->setText(QString("Paint p50 %0 ms, p90 %1 ms").arg(p50.paint, 0, 'f', 0).arg(p90.paint, 0, 'f', 0));
+    this->m_latency_label->setToolTip(QString("Latencies of the last %0 style sheets applied\n").arg(this->m_ss_server->latencyCount()) +
+                                      line.arg("Edit to receive").arg(p50.receive, 0, 'f', 0).arg(p90.receive, 0, 'f', 0)
+                                          .arg(p99.receive, 0, 'f', 0) + "\n" +
+                                      line.arg("Apply").arg(p50.apply, 0, 'f', 1).arg(p90.apply, 0, 'f', 1)
+                                          .arg(p99.apply, 0, 'f', 1) + "\n" +
+                                      line.arg("Edit to paint").arg(p50.paint, 0, 'f', 0).arg(p90.paint, 0, 'f', 0)
+                                          .arg(p99.paint, 0, 'f', 0));
+    this->m_latency_label->setVisible(this->m_ss_server->latencyCount() > 0);
+}
+
+void MainWindow::setStyleSheetText(const QString& style_sheet)
+{
+    this->m_style_sheet = style_sheet;
+    this->m_style_sheet_hash = qHash(style_sheet);
+    this->m_style_index.setRules(QssParser::parse(style_sheet));
+}
+
+void MainWindow::updateDockWidgetStyleSheet(QDockWidget* dw)
+{
+    // hidden dockwidgets are updated when they are shown again
+    if(dw->isHidden())
+        return;
+
+    UiStyleState& state = this->m_ui_styles[dw];
+    this->restoreOwnStyleSheets(state);
+
+    // setting a style sheet re-polishes the whole widget tree, so skip the sheet if it is already applied
+    if(state.style_sheet_hash == this->m_style_sheet_hash && state.style_sheet == this->m_style_sheet)
+        return;
+
+    dw->widget()->setStyleSheet(this->m_style_sheet);
+    state.style_sheet = this->m_style_sheet;
+    state.style_sheet_hash = this->m_style_sheet_hash;
+    state.rules = this->m_style_index.rules();
+}
+
+bool MainWindow::updateDockWidgetStyleSheetPartially(QDockWidget* dw)
+{
+    if(dw->isHidden() || !this->m_ui_styles.contains(dw))
+        return false;
+
+    // the rules are compared with the rules of the last full update, so they must have the same selectors
+    UiStyleState& state = this->m_ui_styles[dw];
+    const QList<QssRule>& rules = this->m_style_index.rules();
+    if(state.style_sheet.isNull() || rules.count() != state.rules.count())
+        return false;
+
+    QList<QssCompoundSelector> subjects;
+    for(int i = 0; i < rules.count(); ++i)
+    {
+        const QssRule& old_rule = state.rules[i];
+        const QssRule& rule = rules[i];
+        if(rule.selector != old_rule.selector)
+            return false;
+        if(rule.body == old_rule.body)
+            continue;
+
+        // a removed property would still apply through the style sheet of the user interface
+        QStringList properties = rule.properties();
+        for(const QString& property: old_rule.properties())
+        {
+            if(!properties.contains(property))
+                return false;
+        }
+
+        // a rule without a class or an object name may apply to any widget
+        for(const QssSelector& selector: rule.selectors)
+        {
+            if(selector.subject().isUniversal())
+                return false;
+            subjects << selector.subject();
+        }
+    }
+
+    // find the widgets matching the changed rules, and keep the widgets of the previous partial updates
+    QSet<QWidget*> widgets;
+    for(QWidget* widget: state.own_style_sheets.keys())
+        widgets.insert(widget);
+
+    for(const QssCompoundSelector& subject: subjects)
+    {
+        QList<QWidget*> candidates = subject.object_name.isEmpty() ? state.widgets_by_class.values(subject.class_name) : state.widgets_by_name.values(subject.object_name);
+        for(QWidget* widget: candidates)
+        {
+            if(QssParser::matches(subject, widget))
+                widgets.insert(widget);
+        }
+    }
+
+    // a rule with a broad selector, e.g. "QWidget", matches so many widgets that a style sheet for each of them is
+    // slower than the whole style sheet
+    if(widgets.count() > PartialUpdateMaxWidgets)
+        return false;
+
+    // a style sheet of declarations only cannot be combined with rules
+    for(QWidget* widget: widgets)
+    {
+        QString own_style_sheet = state.own_style_sheets.value(widget, widget->styleSheet());
+        if(!own_style_sheet.trimmed().isEmpty() && !own_style_sheet.contains('{'))
+            return false;
+    }
+
+    // give each widget its own style sheet followed by all the rules that may apply to it. the style sheet of a
+    // widget takes precedence over the style sheets of its parents, so the new rules override the old ones.
+    // the rules are qualified with a property of the widget, so they don't cascade to its children
+    for(QWidget* widget: widgets)
+    {
+        if(!state.own_style_sheets.contains(widget))
+            state.own_style_sheets[widget] = widget->styleSheet();
+
+        QString id = QString::number(quintptr(widget), 16);
+        widget->setProperty("_g_partial_preview", id);
+        QString style_sheet = state.own_style_sheets[widget];
+        for(const int& i: this->m_style_index.rulesFor(widget))
+        {
+            style_sheet += "\n" + this->partialRule(rules[i], id);
+        }
+
+        if(widget->styleSheet() != style_sheet)
+            widget->setStyleSheet(style_sheet);
+    }
+
+    return true;
+}
+
+void MainWindow::restoreOwnStyleSheets(UiStyleState& state)
+{
+    QHash<QWidget*, QString>::const_iterator it = state.own_style_sheets.constBegin();
+    for(; it != state.own_style_sheets.constEnd(); ++it)
+    {
+        it.key()->setProperty("_g_partial_preview", QVariant());
+        it.key()->setStyleSheet(it.value());
+    }
+    state.own_style_sheets.clear();
+}
+
+QString MainWindow::partialRule(const QssRule& rule, const QString& id) const
+{
+    QStringList selectors;
+    for(const QssSelector& selector: rule.selectors)
+    {
+        QString text;
+        for(int i = 0; i < selector.compounds.count(); ++i)
+        {
+            QssCompoundSelector compound = selector.compounds[i];
+            if(i == selector.compounds.count() - 1)
+                compound.attributes << QString("_g_partial_preview=\"%0\"").arg(id);
+            if(compound.combinator == '>')
+                text += " > ";
+            else if(!compound.combinator.isNull())
+                text += " ";
+            text += compound.toString();
+        }
+        selectors << text;
+    }
+    return selectors.join(", ") + " { " + rule.body + " }";
+}
+
+void MainWindow::indexDockWidget(QDockWidget* dw)
+{
+    UiStyleState& state = this->m_ui_styles[dw];
+    state.widgets_by_class.clear();
+    state.widgets_by_name.clear();
+
+    QList<QWidget*> widgets = dw->widget()->findChildren<QWidget*>();
+    widgets.prepend(dw->widget());
+    for(QWidget* widget: widgets)
+    {
+        for(const QMetaObject* mo = widget->metaObject(); mo; mo = mo->superClass())
+        {
+            state.widgets_by_class.insert(QString(mo->className()), widget);
+        }
+
+        if(!widget->objectName().isEmpty())
+            state.widgets_by_name.insert(widget->objectName(), widget);
     }
 }
 
@@ -589,13 +866,21 @@ void MainWindow::on_actionSave_As_triggered()
 void MainWindow::on_action_Export_triggered()
 {
     // write the style sheet
-    if(this->m_se_widget->saveStyleSheet()) {
+    if(this->m_se_widget->saveStyleSheet("", ui->actionMinify_Export->isChecked())) {
         // generate styling code for the widgets
         foreach(QDockWidget* dw, this->m_ui_dockwidgets_map)
         {
             if(ui->actionCpp) CodeGen::generate(dw->widget(), "C++");
             if(ui->actionPython) CodeGen::generate(dw->widget(), "Python");
         }
+
+        // write the style sheet sections of the forms
+        if(ui->actionBundle_Export->isChecked()) {
+            QMap<QString, QWidget*> forms;
+            QMap<QString, QDockWidget*>::const_iterator it = this->m_ui_dockwidgets_map.constBegin();
+            for(; it != this->m_ui_dockwidgets_map.constEnd(); ++it) forms[it.key()] = it.value()->widget();
+            this->m_se_widget->saveStyleSheetBundle(forms);
+        }
     }
 }
 
@@ -767,6 +1052,9 @@ int MainWindow::reset()
         dw->deleteLater();
     }
     this->m_ui_dockwidgets_map.clear();
+    this->m_ui_styles.clear();
+    this->m_settle_timer->stop();
+    this->setStyleSheetText(QString());
 
     return result;
 }
@@ -811,9 +1099,9 @@ void MainWindow::openStyleSheetProject(const QString& filename)
     this->setWindowTitle(this->m_workspace->appWindowTitle(this->m_project->projectFilename(), true));
 
     // apply the stylesheet to the widgets
-    QString style_sheet = this->m_se_widget->generateStyleSheet();
+    this->setStyleSheetText(this->m_se_widget->generateStyleSheet());
     foreach(QDockWidget* dw, this->m_ui_dockwidgets_map) {
-        dw->widget()->setStyleSheet(style_sheet);
+        this->updateDockWidgetStyleSheet(dw);
     }
 
     // apply margins and spacings
@@ -40,7 +40,12 @@
 #include <QMainWindow>
 #include <QProcess>
 #include <QMap>
+#include <QHash>
 #include <QModelIndex>
+#include <QMultiHash>
+
+// Local Libraries
+#include "qssruleindex.h"
 
 
 namespace Ui {
@@ -51,6 +56,8 @@ class MainWindow;
 class QCloseEvent;
 class QStandardItemModel;
 class QStandardItem;
+class QTimer;
+class QLabel;
 
 class Workspace;
 class Project;
@@ -69,6 +76,19 @@ struct AppObject
     QString obj_class = "";
 };
 
+/**
+ * @brief The UiStyleState struct contains the style sheet state of a user interface dockwidget.
+ */
+struct UiStyleState
+{
+    QMultiHash<QString, QWidget*> widgets_by_class; // the widgets by their class names and the names of their super classes
+    QMultiHash<QString, QWidget*> widgets_by_name; // the widgets by their object names
+    QString style_sheet; // the style sheet applied to the whole user interface
+    uint style_sheet_hash = 0;
+    QList<QssRule> rules; // the rules of the applied style sheet
+    QHash<QWidget*, QString> own_style_sheets; // the original style sheets of the widgets with a partial style sheet
+};
+
 class MainWindow : public QMainWindow
 {
     Q_OBJECT
@@ -77,6 +97,11 @@ public:
     explicit MainWindow(QWidget *parent = nullptr);
     ~MainWindow() override;
 
+    /** The largest number of widgets of a dockwidget that a partial update restyles. Beyond it the whole style sheet
+     * is applied, which re-polishes each widget once.
+     */
+    static const int PartialUpdateMaxWidgets = 32;
+
 protected:
     void writeSettings();
     void readSettings();
@@ -144,6 +169,37 @@ protected:
      */
     QDockWidget* selectedDockWidget();
 
+    /**
+     * @brief updateDockWidgetStyleSheet applies the latest style sheet to a visible dockwidget,
+     * unless the dockwidget already has it
+     */
+    void updateDockWidgetStyleSheet(QDockWidget* dw);
+
+    /**
+     * @brief updateDockWidgetStyleSheetPartially applies the rules that changed since the last full update
+     * to the widgets matching their selectors only
+     * @return false if the changes cannot be applied partially
+     */
+    bool updateDockWidgetStyleSheetPartially(QDockWidget* dw);
+
+    /**
+     * @brief partialRule returns a rule of a partial update with the selectors restricted to the widget
+     * that has the given id in its "_g_partial_preview" property
+     */
+    QString partialRule(const QssRule& rule, const QString& id) const;
+
+    /**
+     * @brief restoreOwnStyleSheets removes the partial style sheets of the widgets in a dockwidget
+     */
+    void restoreOwnStyleSheets(UiStyleState& state);
+
+    /**
+     * @brief indexDockWidget collects the class and object names of the widgets in a dockwidget
+     */
+    void indexDockWidget(QDockWidget* dw);
+
+    void setStyleSheetText(const QString& style_sheet);
+
     // ------------------------------------
     // Event filter functions
     bool eventFilter(QObject *obj, QEvent *event) override;
@@ -152,6 +208,14 @@ protected:
 private slots:
     void applyStyleSheet(const QString& style_sheet);
 
+    void settleStyleSheets();
+
+    void publishStyleSheet(const QString& style_sheet);
+
+    void updateClientsStatus();
+
+    void updateLatencyStatus();
+
     void setIcons();
 
     // ------------------------------------
@@ -215,8 +279,24 @@ private:
 
     StyleSheetEditorWidget* m_se_widget;
 
+    StyleSheetServer* m_ss_server; // publishes the style sheet to the running applications
+
+    QLabel* m_clients_label; // shows the revisions the running applications have applied
+
+    QLabel* m_latency_label; // shows the percentiles of the latencies from an edit to the paint in the applications
+
     QMap<QString, QDockWidget*> m_ui_dockwidgets_map; // the key is the filename of the ui file
 
+    QHash<QDockWidget*, UiStyleState> m_ui_styles; // the style sheet state of each dockwidget
+
+    QString m_style_sheet; // the latest generated style sheet
+
+    uint m_style_sheet_hash;
+
+    QssRuleIndex m_style_index; // the rules of the latest generated style sheet
+
+    QTimer* m_settle_timer; // applies the whole style sheet after a partial preview
+
     QStandardItemModel* m_files_model;
 
     Project* m_project;
@@ -0,0 +1,83 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 George Sithole
+** Contact: http://www.geovariant.com/qttitude/
+**
+** This is free software distributed under the terms of the GNU General Public License, GPL v3.
+**
+** "Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are
+** met:
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in
+**     the documentation and/or other materials provided with the
+**     distribution.
+**   * Neither the name of Qttitude nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+**
+****************************************************************************/
+
+// Qt Libraries
+#include <QDateTime>
+
+// Local Libraries
+#include "previewscheduler.h"
+
+
+PreviewScheduler::PreviewScheduler(QObject *parent) :
+    QObject(parent),
+    m_request_time(0),
+    m_revision(0),
+    m_latency(100),
+    m_idle_interval(16)
+{
+    m_timer.setSingleShot(true);
+    connect(&m_timer, SIGNAL(timeout()), this, SLOT(processTimeout()));
+}
+
+void PreviewScheduler::setLatency(const int& msec)
+{
+    m_latency = qMax(0, msec);
+}
+
+void PreviewScheduler::request()
+{
+    ++m_revision;
+
+    // start measuring the latency from the first request of a burst
+    if(!m_timer.isActive())
+    {
+        m_pending_timer.start();
+        m_request_time = QDateTime::currentMSecsSinceEpoch();
+    }
+
+    // wait for the edits to pause, but not beyond the latency budget
+    qint64 remaining = m_latency - m_pending_timer.elapsed();
+    int interval = int(qBound(qint64(0), remaining, qint64(m_idle_interval)));
+    m_timer.start(interval);
+}
+
+void PreviewScheduler::cancel()
+{
+    m_timer.stop();
+}
+
+void PreviewScheduler::processTimeout()
+{
+    emit this->updateRequested(m_revision);
+}
@@ -0,0 +1,113 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 George Sithole
+** Contact: http://www.geovariant.com/qttitude/
+**
+** This is free software distributed under the terms of the GNU General Public License, GPL v3.
+**
+** "Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are
+** met:
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in
+**     the documentation and/or other materials provided with the
+**     distribution.
+**   * Neither the name of Qttitude nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+**
+****************************************************************************/
+
+#ifndef PREVIEWSCHEDULER_H
+#define PREVIEWSCHEDULER_H
+
+// Qt Libraries
+#include <QObject>
+#include <QTimer>
+#include <QElapsedTimer>
+
+
+/**
+ * @brief The PreviewScheduler class
+ *
+ * Coalesces bursts of preview requests into a single update. Every request restarts a short idle
+ * interval, so an update runs once the edits pause, but never later than the latency budget after
+ * the first pending request. Each request has a revision number; an update whose revision is older
+ * than the latest request is stale and can be skipped.
+ */
+
+class PreviewScheduler : public QObject
+{
+    Q_OBJECT
+public:
+    explicit PreviewScheduler(QObject *parent = nullptr);
+
+    /** This member function sets the longest time, in milliseconds, between a request and its update.
+     */
+    void setLatency(const int& msec);
+
+    /** This member function returns the latency budget in milliseconds.
+     */
+    int latency() const {return m_latency;}
+
+    /** This member function returns the revision of the latest request.
+     */
+    quint64 revision() const {return m_revision;}
+
+    /** This member function returns true if a newer request than revision has been made.
+     */
+    bool isStale(const quint64& revision) const {return revision < m_revision;}
+
+    /** This member function returns the time of the first request of the latest burst, in milliseconds since the
+     * epoch, so the latency of the preview can be measured from the edit.
+     */
+    qint64 requestTime() const {return m_request_time;}
+
+signals:
+    void updateRequested(quint64 revision);
+
+public slots:
+    /** This member function requests an update.
+     */
+    void request();
+
+    /** This member function discards the pending requests.
+     */
+    void cancel();
+
+private slots:
+    void processTimeout();
+
+private:
+    QTimer m_timer;
+
+    /** This member variable measures the time since the first pending request.
+     */
+    QElapsedTimer m_pending_timer;
+
+    qint64 m_request_time;
+
+    quint64 m_revision;
+
+    int m_latency;
+
+    /** This member variable contains the quiet period, in milliseconds, after which pending requests are updated.
+     */
+    int m_idle_interval;
+};
+
+#endif // PREVIEWSCHEDULER_H
@@ -0,0 +1,239 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 George Sithole
+** Contact: http://www.geovariant.com/qttitude/
+**
+** This is free software distributed under the terms of the GNU General Public License, GPL v3.
+**
+** "Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are
+** met:
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in
+**     the documentation and/or other materials provided with the
+**     distribution.
+**   * Neither the name of Qttitude nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+**
+****************************************************************************/
+
+// Qt Libraries
+#include <QHash>
+#include <QRegularExpression>
+#include <QSet>
+#include <QStringList>
+
+// Local Libraries
+#include "qssminifier.h"
+
+
+QString QssMinifier::minify(const QString& text)
+{
+    return QssMinifier::toString(QssMinifier::optimize(QssParser::parse(text)));
+}
+
+QList<QssRule> QssMinifier::optimize(const QList<QssRule>& rules)
+{
+    QList<QssRule> optimized;
+    QList<bool> removed;
+    QHash<QString, int> last_rules; // the last rule of each selector group
+
+    for(const QssRule& r: rules)
+    {
+        QssRule rule = r;
+        rule.declarations = QssMinifier::removeOverridden(rule.declarations);
+        if(rule.declarations.isEmpty() || rule.selectors.isEmpty())
+            continue;
+
+        QString key = QssMinifier::selectorKey(rule);
+        int j = optimized.count();
+        int i = last_rules.value(key, -1);
+        last_rules[key] = j;
+
+        if(i >= 0)
+        {
+            QssRule& earlier = optimized[i];
+
+            // test if a rule in between declares a property of the same family as the earlier rule
+            QSet<QString> families;
+            for(const QssDeclaration& declaration: earlier.declarations)
+                families.insert(QssMinifier::propertyFamily(declaration.property));
+
+            bool conflict = false;
+            for(int k = i + 1; k < j && !conflict; ++k)
+            {
+                if(removed[k])
+                    continue;
+                for(const QssDeclaration& declaration: optimized[k].declarations)
+                {
+                    if(families.contains(QssMinifier::propertyFamily(declaration.property)))
+                    {
+                        conflict = true;
+                        break;
+                    }
+                }
+            }
+
+            if(!conflict)
+            {
+                // move the declarations of the earlier rule to this rule
+                rule.declarations = QssMinifier::removeOverridden(earlier.declarations + rule.declarations);
+                removed[i] = true;
+            }
+            else
+            {
+                // the rules match the same widgets with the same specificity, so this rule overrides the earlier one,
+                // except for the important declarations that this rule does not declare as important again
+                QSet<QString> properties;
+                QSet<QString> important_properties;
+                for(const QssDeclaration& declaration: rule.declarations)
+                {
+                    properties.insert(declaration.property);
+                    if(QssMinifier::isImportant(declaration))
+                        important_properties.insert(declaration.property);
+                }
+
+                QList<QssDeclaration> declarations;
+                for(const QssDeclaration& declaration: earlier.declarations)
+                {
+                    const QSet<QString>& overriding = QssMinifier::isImportant(declaration) ? important_properties : properties;
+                    if(!overriding.contains(declaration.property))
+                        declarations << declaration;
+                }
+                earlier.declarations = declarations;
+                removed[i] = declarations.isEmpty();
+            }
+        }
+
+        optimized << rule;
+        removed << false;
+    }
+
+    QList<QssRule> result;
+    for(int i = 0; i < optimized.count(); ++i)
+    {
+        if(!removed[i])
+            result << optimized[i];
+    }
+    return result;
+}
+
+QString QssMinifier::toString(const QList<QssRule>& rules)
+{
+    QString text;
+    for(const QssRule& rule: rules)
+    {
+        QStringList selectors;
+        for(const QssSelector& selector: rule.selectors)
+            selectors << QssMinifier::compact(selector.text, ">");
+
+        QStringList declarations;
+        for(const QssDeclaration& declaration: rule.declarations)
+            declarations << declaration.property + ":" + QssMinifier::compact(declaration.value, ",(");
+
+        text += selectors.join(",") + "{" + declarations.join(";") + "}";
+    }
+    return text;
+}
+
+QString QssMinifier::selectorKey(const QssRule& rule)
+{
+    QStringList selectors;
+    for(const QssSelector& selector: rule.selectors)
+        selectors << QssMinifier::compact(selector.text, ">");
+    return selectors.join(",");
+}
+
+QString QssMinifier::propertyFamily(const QString& property)
+{
+    // e.g. "border-top-color" is in the "border" family
+    int dash = property.indexOf('-');
+    return dash > 0 ? property.left(dash) : property;
+}
+
+bool QssMinifier::isImportant(const QssDeclaration& declaration)
+{
+    static const QRegularExpression important("!\\s*important\\s*$", QRegularExpression::CaseInsensitiveOption);
+    return important.match(declaration.value).hasMatch();
+}
+
+QList<QssDeclaration> QssMinifier::removeOverridden(const QList<QssDeclaration>& declarations)
+{
+    // a declaration is overridden by a later declaration of the same property, and by an important declaration of
+    // the same property anywhere in the list. an important declaration is only overridden by a later important one
+    QSet<QString> important_properties;
+    for(const QssDeclaration& declaration: declarations)
+    {
+        if(QssMinifier::isImportant(declaration))
+            important_properties.insert(declaration.property);
+    }
+
+    QSet<QString> properties;
+    QSet<QString> later_important_properties;
+    QList<QssDeclaration> result;
+    for(int i = declarations.count() - 1; i >= 0; --i)
+    {
+        const QssDeclaration& declaration = declarations[i];
+        if(QssMinifier::isImportant(declaration))
+        {
+            if(later_important_properties.contains(declaration.property))
+                continue;
+            later_important_properties.insert(declaration.property);
+        }
+        else if(properties.contains(declaration.property) || important_properties.contains(declaration.property))
+        {
+            continue;
+        }
+        properties.insert(declaration.property);
+        result.prepend(declaration);
+    }
+    return result;
+}
+
+QString QssMinifier::compact(const QString& text, const QString& separators)
+{
+    // collapse white space, and remove it next to the separators. strings are kept as they are
+    QString result;
+    QChar quote;
+    bool space = false;
+    for(const QChar& c: text)
+    {
+        if(!quote.isNull())
+        {
+            result += c;
+            if(c == quote)
+                quote = QChar();
+            continue;
+        }
+
+        if(c.isSpace())
+        {
+            space = true;
+            continue;
+        }
+
+        if(space && !result.isEmpty() && !separators.contains(c) && !separators.contains(result.at(result.length() - 1)))
+            result += ' ';
+        space = false;
+
+        if(c == '"' || c == '\'')
+            quote = c;
+        result += c;
+    }
+    return result;
+}
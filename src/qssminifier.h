@@ -0,0 +1,81 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 George Sithole
+** Contact: http://www.geovariant.com/qttitude/
+**
+** This is free software distributed under the terms of the GNU General Public License, GPL v3.
+**
+** "Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are
+** met:
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in
+**     the documentation and/or other materials provided with the
+**     distribution.
+**   * Neither the name of Qttitude nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+**
+****************************************************************************/
+
+#ifndef QSSMINIFIER_H
+#define QSSMINIFIER_H
+
+// Qt Libraries
+#include <QString>
+#include <QList>
+
+// Local Libraries
+#include "qssparser.h"
+
+
+/**
+ * @brief The QssMinifier class writes a style sheet without comments and white space, and removes the rules and
+ * declarations that do not change its styling.
+ *
+ * Rules with the same selectors are merged into the last of them when no rule in between declares a property of the
+ * same family, e.g. "border" and "border-color". Otherwise only the declarations the later rule overrides are removed.
+ * An important declaration, e.g. "color: red !important", is only overridden by a later important declaration.
+ */
+class QssMinifier
+{
+public:
+    /** This member function returns the minified style sheet.
+     */
+    static QString minify(const QString& text);
+
+    /** This member function merges the rules with the same selectors and removes the overridden declarations.
+     */
+    static QList<QssRule> optimize(const QList<QssRule>& rules);
+
+    /** This member function writes rules without white space.
+     */
+    static QString toString(const QList<QssRule>& rules);
+
+protected:
+    static QString selectorKey(const QssRule& rule);
+
+    static QString propertyFamily(const QString& property);
+
+    static bool isImportant(const QssDeclaration& declaration);
+
+    static QList<QssDeclaration> removeOverridden(const QList<QssDeclaration>& declarations);
+
+    static QString compact(const QString& text, const QString& separators);
+};
+
+#endif // QSSMINIFIER_H
@@ -0,0 +1,321 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 George Sithole
+** Contact: http://www.geovariant.com/qttitude/
+**
+** This is free software distributed under the terms of the GNU General Public License, GPL v3.
+**
+** "Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are
+** met:
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in
+**     the documentation and/or other materials provided with the
+**     distribution.
+**   * Neither the name of Qttitude nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+**
+****************************************************************************/
+
+// Qt Libraries
+#include <QObject>
+#include <QMetaObject>
+
+// Local Libraries
+#include "qssparser.h"
+
+
+QString QssCompoundSelector::toString() const
+{
+    QString text = this->class_name.isEmpty() ? QString("*") : QString(this->exact_class ? "." : "") + this->class_name;
+    if(!this->object_name.isEmpty())
+        text += "#" + this->object_name;
+    for(const QString& attribute: this->attributes)
+        text += "[" + attribute + "]";
+    for(const QString& pseudo_state: this->pseudo_states)
+        text += ":" + pseudo_state;
+    if(!this->sub_control.isEmpty())
+        text += "::" + this->sub_control;
+    return text;
+}
+
+int QssSelector::specificity() const
+{
+    // ids, then attributes and pseudo-states, then types and sub-controls
+    int ids = 0;
+    int attributes = 0;
+    int types = 0;
+    for(const QssCompoundSelector& compound: this->compounds)
+    {
+        ids += compound.object_name.isEmpty() ? 0 : 1;
+        attributes += compound.attributes.count() + compound.pseudo_states.count();
+        types += (compound.class_name.isEmpty() ? 0 : 1) + (compound.sub_control.isEmpty() ? 0 : 1);
+    }
+    return ids * 10000 + attributes * 100 + types;
+}
+
+QStringList QssRule::properties() const
+{
+    QStringList names;
+    for(const QssDeclaration& declaration: this->declarations)
+        names << declaration.property;
+    return names;
+}
+
+QList<QssRule> QssParser::parse(const QString& text)
+{
+    QList<QssRule> rules;
+    QString selector;
+    QString body;
+    int depth = 0;
+    QChar quote;
+
+    const int length = text.length();
+    for(int i = 0; i < length; ++i)
+    {
+        QChar c = text[i];
+
+        // skip comments
+        if(quote.isNull() && c == '/' && i + 1 < length && text[i + 1] == '*')
+        {
+            int end = text.indexOf("*/", i + 2);
+            i = end < 0 ? length : end + 1;
+            continue;
+        }
+
+        // copy strings as they are
+        if(!quote.isNull())
+        {
+            if(c == quote)
+                quote = QChar();
+        }
+        else if(c == '"' || c == '\'')
+        {
+            quote = c;
+        }
+        else if(c == '{')
+        {
+            if(depth++ == 0)
+                continue;
+        }
+        else if(c == '}' && depth > 0)
+        {
+            if(--depth == 0)
+            {
+                QssRule rule;
+                rule.selector = selector.simplified();
+                rule.body = body.trimmed();
+                rule.selectors = QssParser::parseSelectors(rule.selector);
+                rule.declarations = QssParser::parseDeclarations(rule.body);
+                rules << rule;
+                selector.clear();
+                body.clear();
+                continue;
+            }
+        }
+
+        if(depth == 0)
+            selector += c;
+        else
+            body += c;
+    }
+
+    return rules;
+}
+
+QList<QssSelector> QssParser::parseSelectors(const QString& text)
+{
+    QList<QssSelector> selectors;
+    for(const QString& part: QssParser::split(text, ','))
+    {
+        QssSelector selector;
+        selector.text = part.simplified();
+
+        int pos = 0;
+        const QString& s = selector.text;
+        while(pos < s.length())
+        {
+            // read the combinator before the compound selector
+            QChar combinator;
+            while(pos < s.length() && (s[pos].isSpace() || s[pos] == '>' || s[pos] == '+' || s[pos] == '~'))
+            {
+                if(s[pos] == '>')
+                    combinator = '>';
+                else if(combinator.isNull())
+                    combinator = ' ';
+                ++pos;
+            }
+            if(pos >= s.length())
+                break;
+
+            QssCompoundSelector compound = QssParser::parseCompound(s, pos);
+            compound.combinator = selector.compounds.isEmpty() ? QChar() : combinator;
+            selector.compounds << compound;
+        }
+
+        if(!selector.compounds.isEmpty())
+            selectors << selector;
+    }
+    return selectors;
+}
+
+QList<QssDeclaration> QssParser::parseDeclarations(const QString& body)
+{
+    QList<QssDeclaration> declarations;
+    for(const QString& text: QssParser::split(body, ';'))
+    {
+        int colon = text.indexOf(':');
+        if(colon > 0)
+        {
+            QssDeclaration declaration;
+            declaration.property = text.left(colon).trimmed().toLower();
+            declaration.value = text.mid(colon + 1).trimmed();
+            declarations << declaration;
+        }
+    }
+    return declarations;
+}
+
+bool QssParser::matches(const QssCompoundSelector& selector, const QObject* object)
+{
+    if(!selector.object_name.isEmpty() && selector.object_name != object->objectName())
+        return false;
+
+    if(selector.class_name.isEmpty())
+        return true;
+
+    const QMetaObject* mo = object->metaObject();
+    if(selector.exact_class)
+        return selector.class_name == QLatin1String(mo->className());
+
+    for(; mo; mo = mo->superClass())
+    {
+        if(selector.class_name == QLatin1String(mo->className()))
+            return true;
+    }
+    return false;
+}
+
+QssCompoundSelector QssParser::parseCompound(const QString& text, int& pos)
+{
+    QssCompoundSelector compound;
+
+    // read the type or class selector
+    if(pos < text.length() && text[pos] == '*')
+    {
+        ++pos;
+    }
+    else
+    {
+        compound.exact_class = pos < text.length() && text[pos] == '.';
+        if(compound.exact_class)
+            ++pos;
+        compound.class_name = QssParser::readName(text, pos);
+    }
+
+    // read the object name, attributes, sub-control and pseudo-states
+    while(pos < text.length() && !text[pos].isSpace() && text[pos] != '>' && text[pos] != '+' && text[pos] != '~')
+    {
+        QChar c = text[pos];
+        if(c == '#')
+        {
+            ++pos;
+            compound.object_name = QssParser::readName(text, pos);
+        }
+        else if(c == '[')
+        {
+            // find the closing bracket outside the strings, e.g. of [text="a]b"]
+            int end = pos + 1;
+            QChar quote;
+            for(; end < text.length(); ++end)
+            {
+                if(!quote.isNull())
+                {
+                    if(text[end] == quote)
+                        quote = QChar();
+                }
+                else if(text[end] == '"' || text[end] == '\'')
+                    quote = text[end];
+                else if(text[end] == ']')
+                    break;
+            }
+            compound.attributes << text.mid(pos + 1, end - pos - 1).trimmed();
+            pos = end + 1;
+        }
+        else if(c == ':' && pos + 1 < text.length() && text[pos + 1] == ':')
+        {
+            pos += 2;
+            compound.sub_control = QssParser::readName(text, pos);
+        }
+        else if(c == ':')
+        {
+            ++pos;
+            bool negated = pos < text.length() && text[pos] == '!';
+            if(negated)
+                ++pos;
+            compound.pseudo_states << QString(negated ? "!" : "") + QssParser::readName(text, pos);
+        }
+        else
+        {
+            ++pos; // skip characters that are not part of a selector
+        }
+    }
+
+    return compound;
+}
+
+QString QssParser::readName(const QString& text, int& pos)
+{
+    int start = pos;
+    while(pos < text.length() && (text[pos].isLetterOrNumber() || text[pos] == '_' || text[pos] == '-'))
+        ++pos;
+    return text.mid(start, pos - start);
+}
+
+QStringList QssParser::split(const QString& text, const QChar& separator)
+{
+    // split at the separators that are not in brackets or strings
+    QStringList parts;
+    QString part;
+    int depth = 0;
+    QChar quote;
+    for(const QChar& c: text)
+    {
+        if(!quote.isNull())
+        {
+            if(c == quote)
+                quote = QChar();
+        }
+        else if(c == '"' || c == '\'')
+            quote = c;
+        else if(c == '(' || c == '[')
+            ++depth;
+        else if(c == ')' || c == ']')
+            --depth;
+        else if(c == separator && depth == 0)
+        {
+            parts << part;
+            part.clear();
+            continue;
+        }
+        part += c;
+    }
+    if(!part.trimmed().isEmpty())
+        parts << part;
+    return parts;
+}
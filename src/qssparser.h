@@ -0,0 +1,140 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 George Sithole
+** Contact: http://www.geovariant.com/qttitude/
+**
+** This is free software distributed under the terms of the GNU General Public License, GPL v3.
+**
+** "Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are
+** met:
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in
+**     the documentation and/or other materials provided with the
+**     distribution.
+**   * Neither the name of Qttitude nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+**
+****************************************************************************/
+
+#ifndef QSSPARSER_H
+#define QSSPARSER_H
+
+// Qt Libraries
+#include <QString>
+#include <QStringList>
+#include <QList>
+
+class QObject;
+
+
+/**
+ * @brief The QssDeclaration struct contains a declaration of a rule, e.g. "color: red".
+ */
+struct QssDeclaration
+{
+    QString property; // the property name in lower case
+    QString value;
+
+    QString toString() const {return property + ": " + value + ";";}
+};
+
+/**
+ * @brief The QssCompoundSelector struct contains a compound selector, e.g. "QPushButton#btnOk:hover:!pressed".
+ * An empty class name is the universal selector.
+ */
+struct QssCompoundSelector
+{
+    QChar combinator; // the combinator before the selector, i.e. ' ' or '>', and null for the first selector
+    QString class_name;
+    bool exact_class = false; // true for the class selector, e.g. ".QPushButton"
+    QString object_name;
+    QStringList attributes; // e.g. "flat=\"true\""
+    QString sub_control; // e.g. "drop-down"
+    QStringList pseudo_states; // e.g. "hover" and "!pressed"
+
+    bool isUniversal() const {return class_name.isEmpty() && object_name.isEmpty();}
+
+    /** This member function returns the selector as text, without the combinator.
+     */
+    QString toString() const;
+};
+
+/**
+ * @brief The QssSelector struct contains a complex selector, e.g. "QDialog > QPushButton#btnOk".
+ */
+struct QssSelector
+{
+    QString text;
+    QList<QssCompoundSelector> compounds;
+
+    /** This member function returns the compound selector of the widget the selector applies to.
+     */
+    const QssCompoundSelector& subject() const {return compounds.last();}
+
+    /** This member function returns the CSS specificity of the selector as a single number.
+     */
+    int specificity() const;
+};
+
+/**
+ * @brief The QssRule struct contains a rule of a style sheet, e.g. "QPushButton#btnOk" and "color: red;".
+ */
+struct QssRule
+{
+    QString selector; // the selector group as text, with simplified white space
+    QString body; // the declarations as text
+    QList<QssSelector> selectors;
+    QList<QssDeclaration> declarations;
+
+    QStringList properties() const;
+
+    QString toString() const {return selector + " { " + body + " }";}
+};
+
+
+class QssParser
+{
+public:
+    /** This member function splits a style sheet into its rules and parses their selectors and declarations.
+     * Comments are skipped.
+     */
+    static QList<QssRule> parse(const QString& text);
+
+    /** This member function parses a selector group, e.g. "QLineEdit, QComboBox::drop-down".
+     */
+    static QList<QssSelector> parseSelectors(const QString& text);
+
+    /** This member function parses the declarations of a rule body.
+     */
+    static QList<QssDeclaration> parseDeclarations(const QString& body);
+
+    /** This member function tests if an object may be the subject of a compound selector. The object matches if it
+     * has the object name of the selector and inherits its class. Attributes and pseudo-states are not tested.
+     */
+    static bool matches(const QssCompoundSelector& selector, const QObject* object);
+
+protected:
+    static QssCompoundSelector parseCompound(const QString& text, int& pos);
+
+    static QString readName(const QString& text, int& pos);
+
+    static QStringList split(const QString& text, const QChar& separator);
+};
+
+#endif // QSSPARSER_H
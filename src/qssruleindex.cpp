@@ -0,0 +1,160 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 George Sithole
+** Contact: http://www.geovariant.com/qttitude/
+**
+** This is free software distributed under the terms of the GNU General Public License, GPL v3.
+**
+** "Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are
+** met:
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in
+**     the documentation and/or other materials provided with the
+**     distribution.
+**   * Neither the name of Qttitude nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+**
+****************************************************************************/
+
+// C/C++ Libraries
+#include <algorithm>
+
+// Qt Libraries
+#include <QObject>
+#include <QMetaObject>
+
+// Local Libraries
+#include "qssruleindex.h"
+
+
+QssRuleIndex::QssRuleIndex()
+{
+}
+
+QssRuleIndex::QssRuleIndex(const QList<QssRule>& rules)
+{
+    this->setRules(rules);
+}
+
+void QssRuleIndex::setRules(const QList<QssRule>& rules)
+{
+    this->clear();
+    this->m_rules = rules;
+
+    for(int i = 0; i < rules.count(); ++i)
+    {
+        for(const QssSelector& selector: rules[i].selectors)
+        {
+            // a rule is indexed by its object name only, as every object matching it has the name
+            const QssCompoundSelector& subject = selector.subject();
+            if(!subject.object_name.isEmpty())
+                QssRuleIndex::insert(this->m_by_object_name, subject.object_name, i);
+            else if(!subject.class_name.isEmpty())
+                QssRuleIndex::insert(this->m_by_class, subject.class_name, i);
+            else if(this->m_universal.isEmpty() || this->m_universal.last() != i)
+                this->m_universal << i;
+        }
+
+        for(const QssDeclaration& declaration: rules[i].declarations)
+        {
+            QssRuleIndex::insert(this->m_by_property, declaration.property, i);
+        }
+    }
+}
+
+const QList<QssRule>& QssRuleIndex::rules() const
+{
+    return this->m_rules;
+}
+
+const QssRule& QssRuleIndex::rule(const int& i) const
+{
+    return this->m_rules[i];
+}
+
+int QssRuleIndex::count() const
+{
+    return this->m_rules.count();
+}
+
+QVector<int> QssRuleIndex::rulesForClass(const QString& class_name) const
+{
+    return this->m_by_class.value(class_name);
+}
+
+QVector<int> QssRuleIndex::rulesForObjectName(const QString& object_name) const
+{
+    return this->m_by_object_name.value(object_name);
+}
+
+QVector<int> QssRuleIndex::rulesForProperty(const QString& property) const
+{
+    return this->m_by_property.value(property.toLower());
+}
+
+QVector<int> QssRuleIndex::universalRules() const
+{
+    return this->m_universal;
+}
+
+QVector<int> QssRuleIndex::rulesFor(const QObject* object) const
+{
+    // collect the candidates by the object name and the class names of the object
+    QVector<int> candidates = this->m_universal;
+    candidates += this->m_by_object_name.value(object->objectName());
+    for(const QMetaObject* mo = object->metaObject(); mo; mo = mo->superClass())
+    {
+        candidates += this->m_by_class.value(QString(mo->className()));
+    }
+
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+    // keep the rules with a subject the object matches
+    QVector<int> rules;
+    for(const int& i: candidates)
+    {
+        for(const QssSelector& selector: this->m_rules[i].selectors)
+        {
+            if(QssParser::matches(selector.subject(), object))
+            {
+                rules << i;
+                break;
+            }
+        }
+    }
+    return rules;
+}
+
+void QssRuleIndex::clear()
+{
+    this->m_rules.clear();
+    this->m_by_class.clear();
+    this->m_by_object_name.clear();
+    this->m_by_property.clear();
+    this->m_universal.clear();
+}
+
+void QssRuleIndex::insert(QHash<QString, QVector<int>>& index, const QString& key, const int& i)
+{
+    // the rules are inserted in order, so a rule with several selectors is only added once
+    QVector<int>& rules = index[key];
+    if(rules.isEmpty() || rules.last() != i)
+        rules << i;
+}
@@ -0,0 +1,107 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 George Sithole
+** Contact: http://www.geovariant.com/qttitude/
+**
+** This is free software distributed under the terms of the GNU General Public License, GPL v3.
+**
+** "Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are
+** met:
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in
+**     the documentation and/or other materials provided with the
+**     distribution.
+**   * Neither the name of Qttitude nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+**
+****************************************************************************/
+
+#ifndef QSSRULEINDEX_H
+#define QSSRULEINDEX_H
+
+// Qt Libraries
+#include <QHash>
+#include <QList>
+#include <QVector>
+
+// Local Libraries
+#include "qssparser.h"
+
+
+/**
+ * @brief The QssRuleIndex class indexes the rules of a style sheet by the class names and object names
+ * of their subjects, and by their properties. The rule numbers are returned in the order of the style sheet.
+ */
+class QssRuleIndex
+{
+public:
+    QssRuleIndex();
+
+    explicit QssRuleIndex(const QList<QssRule>& rules);
+
+    /** This member function replaces the indexed rules.
+     */
+    void setRules(const QList<QssRule>& rules);
+
+    const QList<QssRule>& rules() const;
+
+    const QssRule& rule(const int& i) const;
+
+    int count() const;
+
+    /** This member function returns the rules with a subject of the class, e.g. "QPushButton" or ".QPushButton".
+     * The super classes of the class are not searched.
+     */
+    QVector<int> rulesForClass(const QString& class_name) const;
+
+    /** This member function returns the rules with a subject of the object name.
+     */
+    QVector<int> rulesForObjectName(const QString& object_name) const;
+
+    /** This member function returns the rules declaring the property.
+     */
+    QVector<int> rulesForProperty(const QString& property) const;
+
+    /** This member function returns the rules with a subject without a class name and an object name, e.g. "*".
+     */
+    QVector<int> universalRules() const;
+
+    /** This member function returns the rules that may apply to an object, i.e. the rules with a subject the object
+     * matches. Ancestors, attributes and pseudo-states are not tested.
+     */
+    QVector<int> rulesFor(const QObject* object) const;
+
+    void clear();
+
+protected:
+    static void insert(QHash<QString, QVector<int>>& index, const QString& key, const int& i);
+
+private:
+    QList<QssRule> m_rules;
+
+    QHash<QString, QVector<int>> m_by_class;
+
+    QHash<QString, QVector<int>> m_by_object_name;
+
+    QHash<QString, QVector<int>> m_by_property;
+
+    QVector<int> m_universal;
+};
+
+#endif // QSSRULEINDEX_H
@@ -0,0 +1,173 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 George Sithole
+** Contact: http://www.geovariant.com/qttitude/
+**
+** This is free software distributed under the terms of the GNU General Public License, GPL v3.
+**
+** "Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are
+** met:
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in
+**     the documentation and/or other materials provided with the
+**     distribution.
+**   * Neither the name of Qttitude nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+**
+****************************************************************************/
+
+// Qt Libraries
+#include <QWidget>
+#include <QDataStream>
+#include <QDateTime>
+#include <QStringList>
+#include <QVector>
+
+// Local Libraries
+#include "stylesheetbundle.h"
+#include "qssruleindex.h"
+#include "qssminifier.h"
+#include "codegen.h"
+
+
+QList<StyleSheetBundleSection> StyleSheetBundle::sections(const QString& style_sheet, const QMap<QString, QWidget*>& forms)
+{
+    QssRuleIndex index(QssMinifier::optimize(QssParser::parse(style_sheet)));
+    QVector<bool> used(index.count(), false);
+
+    QList<StyleSheetBundleSection> form_sections;
+    QMap<QString, QWidget*>::const_iterator it = forms.constBegin();
+    for(; it != forms.constEnd(); ++it)
+    {
+        QWidget* form = it.value();
+        if(!form)
+            continue;
+
+        // collect the rules that apply to a widget of the form
+        QVector<bool> in_form(index.count(), false);
+        QList<QWidget*> widgets = form->findChildren<QWidget*>();
+        widgets.prepend(form);
+        for(QWidget* widget: widgets)
+        {
+            for(const int& i: index.rulesFor(widget))
+            {
+                in_form[i] = true;
+                used[i] = true;
+            }
+        }
+
+        QList<QssRule> rules;
+        for(int i = 0; i < index.count(); ++i)
+        {
+            if(in_form[i])
+                rules << index.rule(i);
+        }
+
+        StyleSheetBundleSection section;
+        section.form = it.key();
+        section.style_sheet = QssMinifier::toString(rules);
+        form_sections << section;
+    }
+
+    // the common section contains the rules of no form
+    QList<QssRule> rules;
+    for(int i = 0; i < index.count(); ++i)
+    {
+        if(!used[i])
+            rules << index.rule(i);
+    }
+
+    StyleSheetBundleSection common;
+    common.style_sheet = QssMinifier::toString(rules);
+    form_sections.prepend(common);
+
+    return form_sections;
+}
+
+bool StyleSheetBundle::write(const QList<StyleSheetBundleSection>& sections, QIODevice* device)
+{
+    QDataStream stream(device);
+    stream.setVersion(QDataStream::Qt_5_0);
+    stream << StyleSheetBundleReader::Magic << StyleSheetBundleReader::Version << quint32(sections.count());
+    for(const StyleSheetBundleSection& section: sections)
+    {
+        stream << section.form << section.style_sheet.toUtf8();
+    }
+    return stream.status() == QDataStream::Ok;
+}
+
+QString StyleSheetBundle::generateHeader(const QList<StyleSheetBundleSection>& sections, const QString& name)
+{
+    QStringList table;
+    for(const StyleSheetBundleSection& section: sections)
+    {
+        table << QString("        {%1,\n         %2}").arg(StyleSheetBundle::cppString(section.form),
+                                                  StyleSheetBundle::cppString(section.style_sheet));
+    }
+
+    QDateTime local(QDateTime::currentDateTime());
+    QDateTime UTC(local.toTimeSpec(Qt::UTC));
+    QString identifier = StyleSheetBundle::cppIdentifier(name);
+
+    // the arguments are substituted in one pass, as a style sheet may contain place markers, e.g. "%1"
+    QString format_string = CodeGen::formatString(":/codegen/cplusplus_bundle.txt");
+    return format_string.arg(UTC.toString(), identifier.toUpper(), identifier, table.join(",\n"));
+}
+
+QString StyleSheetBundle::cppString(const QString& text)
+{
+    // write the UTF-8 bytes as string literals of at most 100 characters. the literals are concatenated by the compiler
+    QByteArray bytes = text.toUtf8();
+    QStringList literals;
+    QString literal;
+    for(const char& c: bytes)
+    {
+        if(c == '"' || c == '\\' || c == '?')
+        {
+            literal += '\\';
+            literal += QChar(c);
+        }
+        else if(c >= 0x20 && c < 0x7f)
+            literal += QChar(c);
+        else
+            literal += QString("\\%1").arg(uint(uchar(c)), 3, 8, QChar('0'));
+
+        if(literal.length() >= 100)
+        {
+            literals << literal;
+            literal.clear();
+        }
+    }
+    if(!literal.isEmpty() || literals.isEmpty())
+        literals << literal;
+
+    return "\"" + literals.join("\"\n         \"") + "\"";
+}
+
+QString StyleSheetBundle::cppIdentifier(const QString& text)
+{
+    QString identifier;
+    for(const QChar& c: text)
+    {
+        identifier += (c.isLetterOrNumber() && c.unicode() < 0x80) ? c : QChar('_');
+    }
+    if(identifier.isEmpty() || identifier.at(0).isDigit())
+        identifier.prepend('_');
+    return identifier;
+}
@@ -0,0 +1,85 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 George Sithole
+** Contact: http://www.geovariant.com/qttitude/
+**
+** This is free software distributed under the terms of the GNU General Public License, GPL v3.
+**
+** "Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are
+** met:
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in
+**     the documentation and/or other materials provided with the
+**     distribution.
+**   * Neither the name of Qttitude nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+**
+****************************************************************************/
+
+#ifndef STYLESHEETBUNDLE_H
+#define STYLESHEETBUNDLE_H
+
+// Qt Libraries
+#include <QString>
+#include <QList>
+#include <QMap>
+#include <QByteArray>
+
+// Local Libraries
+#include "qssparser.h"
+#include "stylesheetbundlereader.h"
+
+
+class QWidget;
+class QIODevice;
+
+
+/**
+ * @brief The StyleSheetBundle class splits an expanded style sheet into a minified section for each form, so that an
+ * application applies, and Qt parses, only the rules of the forms it shows.
+ *
+ * A form section contains every rule with a subject that a widget of the form matches, in the order of the style
+ * sheet. It is applied to the form, and the common section to the application.
+ *
+ * The binary bundle is read by the applications with StyleSheetBundleReader, in the stylesheetclient library, which
+ * also describes its format.
+ */
+class StyleSheetBundle
+{
+public:
+    /** This member function returns the common section and the sections of the forms. The key of a form is the name
+     * of its section, i.e. the file name of its .ui file.
+     */
+    static QList<StyleSheetBundleSection> sections(const QString& style_sheet, const QMap<QString, QWidget*>& forms);
+
+    /** This member function writes the sections as a binary bundle.
+     */
+    static bool write(const QList<StyleSheetBundleSection>& sections, QIODevice* device);
+
+    /** This member function returns a C++ header with the sections in a constexpr table.
+     */
+    static QString generateHeader(const QList<StyleSheetBundleSection>& sections, const QString& name);
+
+protected:
+    static QString cppString(const QString& text);
+
+    static QString cppIdentifier(const QString& text);
+};
+
+#endif // STYLESHEETBUNDLE_H
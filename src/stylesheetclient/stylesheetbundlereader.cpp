@@ -0,0 +1,108 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 George Sithole
+** Contact: http://www.geovariant.com/qttitude/
+**
+** This is free software distributed under the terms of the GNU General Public License, GPL v3.
+**
+** "Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are
+** met:
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in
+**     the documentation and/or other materials provided with the
+**     distribution.
+**   * Neither the name of Qttitude nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+**
+****************************************************************************/
+
+// Qt Libraries
+#include <QApplication>
+#include <QWidget>
+#include <QDataStream>
+#include <QFile>
+
+// Local Libraries
+#include "stylesheetbundlereader.h"
+
+
+QList<StyleSheetBundleSection> StyleSheetBundleReader::read(QIODevice* device)
+{
+    QDataStream stream(device);
+    stream.setVersion(QDataStream::Qt_5_0);
+
+    quint32 magic = 0, version = 0, count = 0;
+    stream >> magic >> version >> count;
+    if(magic != StyleSheetBundleReader::Magic || version != StyleSheetBundleReader::Version)
+        return QList<StyleSheetBundleSection>();
+
+    QList<StyleSheetBundleSection> sections;
+    for(quint32 i = 0; i < count && stream.status() == QDataStream::Ok; ++i)
+    {
+        QByteArray style_sheet;
+        StyleSheetBundleSection section;
+        stream >> section.form >> style_sheet;
+        section.style_sheet = QString::fromUtf8(style_sheet);
+        sections << section;
+    }
+
+    if(stream.status() != QDataStream::Ok)
+        return QList<StyleSheetBundleSection>();
+    return sections;
+}
+
+QList<StyleSheetBundleSection> StyleSheetBundleReader::read(const QString& filename)
+{
+    QFile file(filename);
+    if(!file.open(QIODevice::ReadOnly))
+        return QList<StyleSheetBundleSection>();
+    return StyleSheetBundleReader::read(&file);
+}
+
+QString StyleSheetBundleReader::styleSheet(const QList<StyleSheetBundleSection>& sections, const QString& form)
+{
+    for(const StyleSheetBundleSection& section: sections)
+    {
+        if(section.form == form)
+            return section.style_sheet;
+    }
+    return QString();
+}
+
+bool StyleSheetBundleReader::apply(const QList<StyleSheetBundleSection>& sections, const QString& form, QWidget* widget)
+{
+    for(const StyleSheetBundleSection& section: sections)
+    {
+        if(section.form == form)
+        {
+            widget->setStyleSheet(section.style_sheet);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool StyleSheetBundleReader::applyCommon(const QList<StyleSheetBundleSection>& sections)
+{
+    if(!qobject_cast<QApplication*>(QCoreApplication::instance()))
+        return false;
+
+    qApp->setStyleSheet(StyleSheetBundleReader::styleSheet(sections, QString()));
+    return true;
+}
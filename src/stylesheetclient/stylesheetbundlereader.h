@@ -0,0 +1,101 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 George Sithole
+** Contact: http://www.geovariant.com/qttitude/
+**
+** This is free software distributed under the terms of the GNU General Public License, GPL v3.
+**
+** "Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are
+** met:
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in
+**     the documentation and/or other materials provided with the
+**     distribution.
+**   * Neither the name of Qttitude nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+**
+****************************************************************************/
+
+#ifndef STYLESHEETBUNDLEREADER_H
+#define STYLESHEETBUNDLEREADER_H
+
+// Qt Libraries
+#include <QString>
+#include <QList>
+
+
+class QWidget;
+class QIODevice;
+
+
+/**
+ * @brief The StyleSheetBundleSection struct contains the minified style sheet of a form. The common section has an
+ * empty form name, and contains the rules that apply to no widget of the forms, e.g. the rules of popups.
+ */
+struct StyleSheetBundleSection
+{
+    QString form; // the file name of the .ui file of the form, e.g. "mainwindow.ui"
+    QString style_sheet;
+};
+
+
+/**
+ * @brief The StyleSheetBundleReader class reads the binary style sheet bundle (.qssb) exported by Qttitude, and applies
+ * its sections in an application.
+ *
+ * The bundle is written with QDataStream (Qt_5_0): the magic number, the version, the number of sections, and the form
+ * name (QString) and UTF-8 style sheet (QByteArray) of each section. A typical application reads the bundle once,
+ * applies the common section to the application, and applies the section of each form when the form is created:
+ *
+ *     QList<StyleSheetBundleSection> sections = StyleSheetBundleReader::read("style.qssb");
+ *     StyleSheetBundleReader::applyCommon(sections);
+ *     StyleSheetBundleReader::apply(sections, "mainwindow.ui", &main_window);
+ */
+class StyleSheetBundleReader
+{
+public:
+    static const quint32 Magic = 0x51535342; // "QSSB"
+
+    static const quint32 Version = 1;
+
+    /** This member function reads the sections of a binary bundle. An empty list is returned for an invalid bundle.
+     */
+    static QList<StyleSheetBundleSection> read(QIODevice* device);
+
+    /** This member function reads the sections of a binary bundle file. An empty list is returned if the file cannot
+     * be read or is not a bundle.
+     */
+    static QList<StyleSheetBundleSection> read(const QString& filename);
+
+    /** This member function returns the style sheet of a form, or the common style sheet for an empty form name. An
+     * empty style sheet is returned if the bundle has no section of the form.
+     */
+    static QString styleSheet(const QList<StyleSheetBundleSection>& sections, const QString& form);
+
+    /** This member function applies the style sheet of a form to the widget. It returns false if the bundle has no
+     * section of the form.
+     */
+    static bool apply(const QList<StyleSheetBundleSection>& sections, const QString& form, QWidget* widget);
+
+    /** This member function applies the common style sheet to the application.
+     */
+    static bool applyCommon(const QList<StyleSheetBundleSection>& sections);
+};
+
+#endif // STYLESHEETBUNDLEREADER_H
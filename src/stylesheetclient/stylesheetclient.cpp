@@ -0,0 +1,638 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 George Sithole
+** Contact: http://www.geovariant.com/qttitude/
+**
+** This is free software distributed under the terms of the GNU General Public License, GPL v3.
+**
+** "Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are
+** met:
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in
+**     the documentation and/or other materials provided with the
+**     distribution.
+**   * Neither the name of Qttitude nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+**
+****************************************************************************/
+
+// C/C++ Libraries
+#include <iostream>
+#include <cstring>
+
+// Qt Libraries
+#include <QApplication>
+#include <QWidget>
+#include <QBuffer>
+#include <QDataStream>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QEvent>
+#include <QStringList>
+
+// Local Libraries
+#include "stylesheetclient.h"
+
+
+StyleSheetClient::StyleSheetClient(QObject *parent) :
+    QObject(parent),
+    m_ss_generation(0),
+    m_ss_sequence(0),
+    m_changes_read(0),
+    m_auto_apply(false),
+    m_applied_sequence(0),
+    m_apply_duration(0),
+    m_ss_edit_time(0),
+    m_receive_time(0),
+    m_applied_edit_time(0),
+    m_applied_receive_time(0),
+    m_paint_time(0),
+    m_paint_pending(false),
+    m_objects_reset(true)
+{
+    // request a style sheet. the server notifies the client of new style sheets, and the timer polls while the
+    // client is not connected to the server
+    int interval = 100;
+    connect(&m_timer, SIGNAL(timeout()), this, SLOT(pollNewData()));
+    m_timer.setInterval(interval);
+    m_timer.start();
+
+    connect(&m_socket, SIGNAL(connected()), this, SLOT(processConnected()));
+    connect(&m_socket, SIGNAL(disconnected()), this, SLOT(processDisconnected()));
+    connect(&m_socket, SIGNAL(readyRead()), this, SLOT(processNotification()));
+    m_socket.connectToServer("StyleSheetServer");
+
+    // apply the style sheets on the next event loop turn
+    m_apply_timer.setSingleShot(true);
+    m_apply_timer.setInterval(0);
+    connect(&m_apply_timer, SIGNAL(timeout()), this, SLOT(applyStyleSheet()));
+
+    // the widgets painted after a style sheet is applied are painted together, so the latencies are reported on the
+    // event loop turn after the first paint
+    m_paint_timer.setSingleShot(true);
+    m_paint_timer.setInterval(0);
+    connect(&m_paint_timer, SIGNAL(timeout()), this, SLOT(reportLatency()));
+
+    // a style sheet may change nothing that is visible, e.g. if it is unchanged or the target is hidden. a later paint
+    // would then be reported as its latency, so the client stops waiting after a while
+    m_paint_timeout.setSingleShot(true);
+    m_paint_timeout.setInterval(PaintTimeout);
+    connect(&m_paint_timeout, SIGNAL(timeout()), this, SLOT(reportNoPaint()));
+
+    // track the objects that are added and removed. the changes are published on the next event loop turn, when
+    // the constructors of the added objects have finished
+    m_objects_timer.setSingleShot(true);
+    m_objects_timer.setInterval(0);
+    connect(&m_objects_timer, SIGNAL(timeout()), this, SLOT(publishObjects()));
+    if(QCoreApplication::instance())
+        QCoreApplication::instance()->installEventFilter(this);
+}
+
+StyleSheetClient::~StyleSheetClient()
+{
+    if(m_ss_memory.isAttached())        m_ss_memory.detach();
+    if(m_ss_control.isAttached())       m_ss_control.detach();
+
+    if(QCoreApplication::instance())
+        QCoreApplication::instance()->removeEventFilter(this);
+
+    disconnect(&m_socket, 0, this, 0);
+    m_socket.abort();
+}
+
+void StyleSheetClient::setTarget(QWidget* widget)
+{
+    m_target = widget;
+}
+
+QWidget* StyleSheetClient::target() const
+{
+    return m_target.data();
+}
+
+void StyleSheetClient::setAutoApply(const bool& state)
+{
+    m_auto_apply = state;
+}
+
+// ---------------------------------------------
+QString StyleSheetClient::getStyleSheet()
+{
+    if(this->styleSheetSequence() == 0)
+        return QString();
+
+    // read the published slot again if the server overwrote it while it was read. the style sheet is decoded from
+    // the segment without copying it first
+    const StyleSheetSegmentHeader* header = (const StyleSheetSegmentHeader*)m_ss_memory.constData();
+    for(int attempt = 0; attempt < 3; ++attempt)
+    {
+        const StyleSheetSlot* slot = header->slot(header->published.loadAcquire() % StyleSheetSegmentHeader::SlotCount);
+        quint32 sequence = slot->sequence.loadAcquire();
+        if(sequence == 0)
+            continue;
+
+        const char* data = (const char*)(slot + 1);
+        quint32 size = qMin(slot->size, header->capacity);
+        qint64 edit_time = slot->edit_time;
+
+        // apply the change to the last style sheet read, and test the result against the checksum of the whole style
+        // sheet. the whole style sheet is read if that fails, and every FullReadInterval style sheets
+        if(m_ss_sequence != 0 && slot->base_sequence == m_ss_sequence && m_changes_read < FullReadInterval &&
+           quint64(slot->byte_offset) + slot->byte_inserted <= size &&
+           quint64(slot->char_offset) + slot->char_removed <= quint64(m_style_sheet.size()))
+        {
+            QByteArray bytes = QByteArray::fromRawData(data + slot->byte_offset, int(slot->byte_inserted));
+            quint16 checksum = qChecksum(bytes.constData(), uint(bytes.size()));
+            QString style_sheet = m_style_sheet;
+            style_sheet.replace(int(slot->char_offset), int(slot->char_removed), QString::fromUtf8(bytes));
+            QByteArray merged = style_sheet.toUtf8();
+
+            if(slot->sequence.loadAcquire() == sequence && checksum == slot->delta_checksum &&
+               quint32(merged.size()) == size && qChecksum(merged.constData(), uint(merged.size())) == slot->checksum)
+            {
+                m_style_sheet = style_sheet;
+                m_ss_sequence = sequence;
+                m_ss_edit_time = edit_time;
+                ++m_changes_read;
+                return m_style_sheet;
+            }
+        }
+
+        QByteArray bytes = QByteArray::fromRawData(data, int(size));
+        quint16 checksum = qChecksum(bytes.constData(), uint(bytes.size()));
+        QString style_sheet = QString::fromUtf8(bytes);
+
+        if(slot->sequence.loadAcquire() == sequence && checksum == slot->checksum)
+        {
+            m_style_sheet = style_sheet;
+            m_ss_sequence = sequence;
+            m_ss_edit_time = edit_time;
+            m_changes_read = 0;
+            return style_sheet;
+        }
+    }
+
+    std::cout << "Failed to read the style sheet" << std::endl;
+    return QString();
+}
+
+bool StyleSheetClient::styleSheetIsAvailable()
+{
+    return this->styleSheetSequence() != m_ss_sequence;
+}
+
+quint32 StyleSheetClient::styleSheetSequence()
+{
+    if(!this->attachStyleSheetMemory())
+        return m_ss_sequence;
+
+    const StyleSheetSegmentHeader* header = (const StyleSheetSegmentHeader*)m_ss_memory.constData();
+    return header->sequence.loadAcquire();
+}
+
+// ---------------------------------------------
+QString StyleSheetClient::readAppWidgets()
+{
+    return this->getAppWidgets();
+}
+
+QByteArray StyleSheetClient::readAppWidgetTree()
+{
+    return this->getAppWidgetTree();
+}
+
+// ---------------------------------------------
+void StyleSheetClient::writeSharedMemory(QSharedMemory& shared_memory, const QString& key, const QVariant& data)
+{
+    // create a buffer and write the data to the buffer
+    QBuffer buffer;
+    buffer.open( QBuffer::ReadWrite );
+    QDataStream out( &buffer );
+    out << data;
+
+    int size = buffer.size();
+
+    // assign the key
+    shared_memory.setKey(key);
+
+    // attach to shared memory
+    if(shared_memory.isAttached())
+    {
+        if(!shared_memory.detach())
+            std::cout << "Failed to detach memory " << shared_memory.key().toStdString() << std::endl;
+    }
+
+    // create the shared memory
+    if(!shared_memory.create(size))
+    {
+        std::cout << "Unable to create shared memory segment." << std::endl;
+        return;
+    }
+
+    // lock the shared memory
+    shared_memory.lock();
+
+    // write into the shared memory
+    char *data_ptr = (char*)shared_memory.data(); // pointer to shared memory
+    const char *from = buffer.data().data();
+    memcpy( data_ptr, from, qMin( shared_memory.size(), size ) );
+
+    // unlock the shared memory
+    shared_memory.unlock();
+
+    //shared_memory.detach();
+}
+
+// ---------------------------------------------
+bool StyleSheetClient::attachStyleSheetMemory()
+{
+    // the segments stay attached between polls
+    if(!m_ss_control.isAttached())
+    {
+        m_ss_control.setKey("StyleSheetSharedMemory");
+        if(!m_ss_control.attach(QSharedMemory::ReadOnly))
+            return false;
+
+        // the client only reads the segments of a server with the same protocol version
+        const StyleSheetControlHeader* control = (const StyleSheetControlHeader*)m_ss_control.constData();
+        if(m_ss_control.size() < int(sizeof(StyleSheetControlHeader)) || control->version != StyleSheetProtocolVersion)
+        {
+            m_ss_control.detach();
+            return false;
+        }
+    }
+
+    // attach to the segment of the current generation
+    const StyleSheetControlHeader* control = (const StyleSheetControlHeader*)m_ss_control.constData();
+    quint32 generation = control->generation.loadAcquire();
+    if(generation == 0)
+        return false;
+
+    if(m_ss_memory.isAttached() && generation == m_ss_generation)
+        return true;
+
+    if(m_ss_memory.isAttached())
+        m_ss_memory.detach();
+
+    m_ss_memory.setKey(StyleSheetSegmentHeader::key(generation));
+    if(!m_ss_memory.attach(QSharedMemory::ReadOnly))
+        return false;
+
+    const StyleSheetSegmentHeader* header = (const StyleSheetSegmentHeader*)m_ss_memory.constData();
+    if(m_ss_memory.size() < int(sizeof(StyleSheetSegmentHeader)) ||
+       m_ss_memory.size() < StyleSheetSegmentHeader::segmentSize(header->capacity))
+    {
+        m_ss_memory.detach();
+        return false;
+    }
+
+    // a new generation may come from a restarted server that numbers its style sheets from the start again,
+    // so its style sheet is read in full and applied even if its sequence number was applied before
+    m_ss_generation = generation;
+    m_ss_sequence = 0;
+    m_style_sheet.clear();
+    m_applied_sequence = 0;
+    return true;
+}
+
+// ---------------------------------------------
+QVariant StyleSheetClient::readFromSharedMemory(const QString& key, QVariant default_value)
+{
+    // set shared memory key
+    QSharedMemory shared_memory;
+    shared_memory.setKey(key);
+
+    // attempt to attach to shared memory segment
+    if (!shared_memory.attach())
+    {
+        // if an attempt of reading from the shared memory before data is written
+        //cout << "ERROR: Failed to attach to shared memory " << key.toStdString() << endl;
+        return default_value;
+    }
+
+    // crate a buffer to read the data in
+    QBuffer buffer;
+    QDataStream in(&buffer);
+    QVariant data;
+
+    // lock the memory
+    if(!shared_memory.lock())
+        std::cout << "Failed to lock" << std::endl;
+
+    // read the data
+    //char* data_ptr = (char*)shared_memory.constData();
+    buffer.setData((char*)shared_memory.constData(), shared_memory.size());
+    buffer.open(QBuffer::ReadOnly);
+
+    in >> data;
+
+    // unlock the memory
+    if(!shared_memory.unlock())
+        std::cout << "Failed to unlock" << std::endl;
+
+    // detach the memory
+    shared_memory.detach();
+
+    return data;
+}
+
+void StyleSheetClient::pollNewData()
+{
+    // connect to the server
+    if(m_socket.state() == QLocalSocket::UnconnectedState)
+        m_socket.connectToServer("StyleSheetServer");
+
+    // read style sheet. it is applied on the next event loop turn, so only the last of a burst of style sheets is
+    // applied
+    if(this->styleSheetIsAvailable())
+    {
+        quint32 sequence = m_ss_sequence;
+        this->getStyleSheet();
+        if(m_ss_sequence != sequence)
+        {
+            m_receive_time = QDateTime::currentMSecsSinceEpoch();
+            if(!m_apply_timer.isActive())
+                m_apply_timer.start();
+        }
+    }
+}
+
+void StyleSheetClient::applyStyleSheet()
+{
+    if(m_ss_sequence == m_applied_sequence)
+        return;
+
+    // apply the style sheet, and measure the time including the connected slots
+    QElapsedTimer timer;
+    timer.start();
+
+    // the last style sheet applied caused no paint
+    if(m_paint_pending)
+        this->reportNoPaint();
+
+    if(m_auto_apply)
+    {
+        if(m_target)
+            m_target->setStyleSheet(m_style_sheet);
+        else if(qobject_cast<QApplication*>(QCoreApplication::instance()))
+            qApp->setStyleSheet(m_style_sheet);
+    }
+    emit this->styleSheetReady(m_style_sheet);
+
+    m_apply_duration = quint32(qMin(timer.nsecsElapsed() / 1000, qint64(0xffffffff)));
+    m_applied_sequence = m_ss_sequence;
+    m_applied_edit_time = m_ss_edit_time;
+    m_applied_receive_time = m_receive_time;
+    m_paint_pending = true;
+    m_paint_timeout.start();
+    this->sendMessage(AcknowledgeMessage);
+}
+
+void StyleSheetClient::reportLatency()
+{
+    m_paint_time = QDateTime::currentMSecsSinceEpoch();
+    this->sendMessage(LatencyMessage);
+}
+
+void StyleSheetClient::reportNoPaint()
+{
+    if(!m_paint_pending)
+        return;
+
+    m_paint_pending = false;
+    m_paint_timeout.stop();
+    m_paint_time = 0;
+    this->sendMessage(LatencyMessage);
+}
+
+void StyleSheetClient::processConnected()
+{
+    // stop polling, and read the style sheet published before the connection
+    m_timer.stop();
+    this->sendMessage(RegisterMessage);
+    this->pollNewData();
+
+    // publish the object tree
+    m_objects_reset = true;
+    this->publishObjects();
+}
+
+void StyleSheetClient::processDisconnected()
+{
+    m_timer.start();
+}
+
+void StyleSheetClient::processNotification()
+{
+    // a notification contains the sequence number, which is read from the shared memory
+    m_socket.readAll();
+    this->pollNewData();
+}
+
+void StyleSheetClient::publishObjects()
+{
+    if(m_socket.state() != QLocalSocket::ConnectedState || this->parent() == Q_NULLPTR)
+    {
+        m_object_changes.clear();
+        return;
+    }
+
+    // wait while the server is behind
+    if(m_socket.bytesToWrite() > 4 * 1024 * 1024)
+    {
+        m_object_changes.clear();
+        m_objects_reset = true;
+        m_objects_timer.start(100);
+        return;
+    }
+
+    QByteArray message;
+    QDataStream out(&message, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_5_0);
+
+    // publish the whole tree when the changes are too many
+    if(m_objects_reset || m_object_changes.count() > 4096)
+    {
+        QByteArray tree;
+        QDataStream tree_out(&tree, QIODevice::WriteOnly);
+        tree_out.setVersion(QDataStream::Qt_5_0);
+        StyleSheetObjectTreeWriter writer(tree_out);
+        m_object_parents.clear();
+        m_object_children.clear();
+        this->addObjectTree(writer, this->parent(), -1);
+        writer.finish();
+
+        out << quint8(ObjectTreeMessage) << tree;
+        m_objects_reset = false;
+    }
+    else
+    {
+        // publish the changes in order. an object moved to another parent is removed and added again
+        for(const ObjectChange& change: m_object_changes)
+        {
+            if(!change.added)
+            {
+                if(m_object_parents.contains(change.id))
+                {
+                    out << quint8(RemoveObjectMessage) << change.id;
+                    this->forgetObject(change.id);
+                }
+            }
+            else if(change.object && !m_object_parents.contains(change.id) &&
+                    change.object->parent() && m_object_parents.contains(quint64(quintptr(change.object->parent()))))
+            {
+                this->addObject(out, change.object);
+            }
+        }
+    }
+    m_object_changes.clear();
+
+    if(!message.isEmpty())
+    {
+        m_socket.write(message);
+        m_socket.flush();
+    }
+}
+
+bool StyleSheetClient::eventFilter(QObject* obj, QEvent* event)
+{
+    if(m_paint_pending && event->type() == QEvent::Paint)
+    {
+        m_paint_pending = false;
+        m_paint_timeout.stop();
+        m_paint_timer.start();
+    }
+
+    if(event->type() == QEvent::ChildAdded || event->type() == QEvent::ChildRemoved)
+    {
+        if(m_socket.state() == QLocalSocket::ConnectedState)
+        {
+            QObject* child = static_cast<QChildEvent*>(event)->child();
+            ObjectChange change;
+            change.id = quint64(quintptr(child));
+            change.added = event->type() == QEvent::ChildAdded;
+            if(change.added)
+                change.object = child; // a removed child may be in its destructor
+            m_object_changes << change;
+
+            if(!m_objects_timer.isActive())
+                m_objects_timer.start(0);
+        }
+    }
+    return QObject::eventFilter(obj, event);
+}
+
+void StyleSheetClient::addObject(QDataStream& out, QObject* object)
+{
+    // write the object and its descendants
+    quint64 id = quint64(quintptr(object));
+    quint64 parent_id = object == this->parent() ? 0 : quint64(quintptr(object->parent()));
+    out << quint8(AddObjectMessage) << id << parent_id << object->objectName()
+        << QString(object->metaObject()->className());
+    m_object_parents.insert(id, parent_id);
+    m_object_children.insert(parent_id, id);
+
+    for(QObject* child: object->children())
+    {
+        if(!m_object_parents.contains(quint64(quintptr(child))))
+            this->addObject(out, child);
+    }
+}
+
+void StyleSheetClient::addObjectTree(StyleSheetObjectTreeWriter& writer, QObject* object, const qint32& parent)
+{
+    quint64 id = quint64(quintptr(object));
+    quint64 parent_id = parent < 0 ? 0 : quint64(quintptr(object->parent()));
+    m_object_parents.insert(id, parent_id);
+    m_object_children.insert(parent_id, id);
+
+    qint32 index = writer.writeNode(object, parent);
+    for(QObject* child: object->children())
+        this->addObjectTree(writer, child, index);
+}
+
+void StyleSheetClient::forgetObject(const quint64& id)
+{
+    for(const quint64& child: m_object_children.values(id))
+        this->forgetObject(child);
+
+    m_object_children.remove(m_object_parents.value(id), id);
+    m_object_children.remove(id);
+    m_object_parents.remove(id);
+}
+
+void StyleSheetClient::sendMessage(const StyleSheetMessage& type)
+{
+    if(m_socket.state() != QLocalSocket::ConnectedState)
+        return;
+
+    QByteArray message;
+    QDataStream out(&message, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_5_0);
+    out << quint8(type);
+    if(type == RegisterMessage)
+        out << StyleSheetProtocolVersion << qint64(QCoreApplication::applicationPid())
+            << QCoreApplication::applicationName();
+    else if(type == AcknowledgeMessage)
+        out << m_applied_sequence << m_apply_duration;
+    else if(type == LatencyMessage)
+        out << m_applied_sequence << m_applied_edit_time << m_applied_receive_time << m_apply_duration << m_paint_time;
+
+    m_socket.write(message);
+    m_socket.flush();
+}
+
+QString StyleSheetClient::getAppWidgets()
+{
+    if(this->parent() != Q_NULLPTR)
+    {
+        QStringList widgets;
+        this->getParentObjects(this->parent(), widgets, 1);
+        return widgets.join('\n');
+    }
+    return QString();
+}
+
+void StyleSheetClient::getParentObjects(QObject* parent, QStringList& objects, const int& depth)
+{
+    // write parent
+    QString object_name = parent->objectName();
+    QString class_name = parent->metaObject()->className();
+    objects << QString("%0,%1,%2").arg(depth).arg(object_name).arg(class_name);
+
+    // write the children
+    for(QObject* child: parent->children())
+    {
+        this->getParentObjects(child, objects, depth + 1);
+    }
+}
+
+QByteArray StyleSheetClient::getAppWidgetTree()
+{
+    QByteArray tree;
+    if(this->parent() != Q_NULLPTR)
+    {
+        QDataStream out(&tree, QIODevice::WriteOnly);
+        out.setVersion(QDataStream::Qt_5_0);
+        StyleSheetObjectTreeWriter writer(out);
+        writer.writeTree(this->parent());
+        writer.finish();
+    }
+    return tree;
+}
@@ -0,0 +1,238 @@
+#ifndef STYLESHEETCLIENT_H
+#define STYLESHEETCLIENT_H
+
+// Qt Libraries
+#include <QObject>
+#include <QSharedMemory>
+#include <QTimer>
+#include <QVariant>
+#include <QLocalSocket>
+#include <QPointer>
+#include <QHash>
+#include <QMultiHash>
+
+// Local Libraries
+#include "stylesheetprotocol.h"
+
+
+class QWidget;
+
+
+/**
+ * @brief The StyleSheetClient class receives the style sheets published by Qttitude, and publishes the object tree of
+ * the application to Qttitude.
+ *
+ * A received style sheet is applied on the next event loop turn, so a burst of style sheets is applied once. The
+ * styleSheetReady() signal is emitted with it, and the application applies it in a connected slot. If auto apply is
+ * on, the client applies it to the target widget, or to the application if there is no target. Auto apply is off by
+ * default, as it applies the style sheet a second time in applications that apply it in their slot. The time it takes
+ * to apply a style sheet, including the slots connected to styleSheetReady(), is reported to Qttitude. So are the time
+ * the style sheet was read and the time of the first paint after it was applied, which Qttitude compares with the time
+ * of the edit.
+ *
+ * The client is linked from the stylesheetclient library, or compiled into the application by including
+ * stylesheetclient.pri in its project file. An application without a slot of its own turns auto apply on:
+ *
+ *     StyleSheetClient* client = new StyleSheetClient(&main_window);
+ *     client->setAutoApply(true);
+ */
+class StyleSheetClient : public QObject
+{
+    Q_OBJECT
+public:
+    /** The object tree of the parent is published. The parent is usually the main window.
+     */
+    explicit StyleSheetClient(QObject *parent = nullptr);
+    ~StyleSheetClient();
+
+    /** This member function sets the widget the style sheets are applied to. The style sheets are applied to the
+     * application if the widget is null.
+     */
+    void setTarget(QWidget* widget);
+
+    QWidget* target() const;
+
+    /** This member function sets whether the style sheets are applied by the client, or only by the slots connected to
+     * styleSheetReady(). It is off by default.
+     */
+    void setAutoApply(const bool& state);
+
+    bool autoApply() const {return m_auto_apply;}
+
+    /** This member function returns the time, in microseconds, it took to apply the last style sheet.
+     */
+    quint32 applyDuration() const {return m_apply_duration;}
+
+    /** The number of style sheets read as changes, after which the whole style sheet is read again.
+     */
+    static const quint32 FullReadInterval = 32;
+
+    /** The time, in milliseconds, the client waits for a paint after it applies a style sheet.
+     */
+    static const int PaintTimeout = 1000;
+
+    // ---------------------------------------------
+    QString getStyleSheet();
+
+    bool styleSheetIsAvailable();
+
+    /** This member function returns the sequence number of the published style sheet, and 0 if the server has not
+     * published a style sheet.
+     */
+    quint32 styleSheetSequence();
+
+    // ---------------------------------------------
+    /** This member function returns the objects of the application as text, a line of "depth,object name,class name"
+     * for each object.
+     */
+    QString readAppWidgets();
+
+    /** This member function returns the object tree of the application in the binary format Qttitude receives over
+     * the local socket, see StyleSheetObjectTreeReader.
+     */
+    QByteArray readAppWidgetTree();
+
+    // ---------------------------------------------
+    void writeSharedMemory(QSharedMemory& shared_memory, const QString& key, const QVariant& data);
+
+    bool attachStyleSheetMemory();
+
+    QVariant readFromSharedMemory(const QString& key, QVariant default_value);
+
+signals:
+    void styleSheetReady(QString style_sheet);
+
+public slots:
+    void pollNewData();
+
+private slots:
+    void processConnected();
+
+    void processDisconnected();
+
+    void processNotification();
+
+    void publishObjects();
+
+    void applyStyleSheet();
+
+    void reportLatency();
+
+    void reportNoPaint();
+
+protected:
+    bool eventFilter(QObject* obj, QEvent* event) override;
+
+    void addObject(QDataStream& out, QObject* object);
+
+    void addObjectTree(StyleSheetObjectTreeWriter& writer, QObject* object, const qint32& parent);
+
+    void forgetObject(const quint64& id);
+
+    void sendMessage(const StyleSheetMessage& type);
+
+    QString getAppWidgets();
+
+    void getParentObjects(QObject* parent, QStringList& objects, const int& depth);
+
+    QByteArray getAppWidgetTree();
+
+private:
+    /** This member variable contains the shared memory with the generation of the style sheet shared memory
+     */
+    QSharedMemory m_ss_control;
+
+    /** This member variable contains the style sheet shared memory. It stays attached while the segment is in use
+     */
+    QSharedMemory m_ss_memory;
+
+    quint32 m_ss_generation;
+
+    /** This member variable contains the last style sheet read, which the changes are applied to
+     */
+    QString m_style_sheet;
+
+    /** This member variable contains the sequence number of the last style sheet read
+     */
+    quint32 m_ss_sequence;
+
+    /** This member variable contains the number of changes applied since the whole style sheet was read
+     */
+    quint32 m_changes_read;
+
+    QTimer m_timer;
+
+    /** This member variable receives the notifications of the server
+     */
+    QLocalSocket m_socket;
+
+    /** This member variable applies the last style sheet read on the next event loop turn
+     */
+    QTimer m_apply_timer;
+
+    QPointer<QWidget> m_target;
+
+    bool m_auto_apply;
+
+    /** This member variable contains the sequence number of the last style sheet applied
+     */
+    quint32 m_applied_sequence;
+
+    quint32 m_apply_duration;
+
+    /** This member variable contains the edit time of the last style sheet read, and the time it was read
+     */
+    qint64 m_ss_edit_time;
+
+    qint64 m_receive_time;
+
+    /** This member variable contains the edit time and the receive time of the last style sheet applied
+     */
+    qint64 m_applied_edit_time;
+
+    qint64 m_applied_receive_time;
+
+    /** This member variable contains the time the widgets painted after the last style sheet applied were done
+     */
+    qint64 m_paint_time;
+
+    /** This member variable is true until a widget is painted after a style sheet is applied
+     */
+    bool m_paint_pending;
+
+    /** This member variable reports the latencies once the widgets painted after a style sheet are done
+     */
+    QTimer m_paint_timer;
+
+    /** This member variable reports that no paint followed a style sheet
+     */
+    QTimer m_paint_timeout;
+
+    /**
+     * @brief The ObjectChange struct contains an object that was added to or removed from a parent.
+     */
+    struct ObjectChange
+    {
+        quint64 id;
+        QPointer<QObject> object;
+        bool added;
+    };
+
+    /** This member variable contains the object changes that are not published yet
+     */
+    QList<ObjectChange> m_object_changes;
+
+    /** This member variable contains the parents of the published objects
+     */
+    QHash<quint64, quint64> m_object_parents;
+
+    QMultiHash<quint64, quint64> m_object_children;
+
+    /** This member variable publishes the object changes on the next event loop turn
+     */
+    QTimer m_objects_timer;
+
+    bool m_objects_reset;
+};
+
+#endif // STYLESHEETCLIENT_H
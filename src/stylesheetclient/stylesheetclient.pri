@@ -0,0 +1,14 @@
+# Include this file in the project file of an application to compile the style sheet client into the application.
+
+QT += core gui network widgets
+
+INCLUDEPATH += $$PWD
+
+HEADERS += \
+    $$PWD/stylesheetprotocol.h \
+    $$PWD/stylesheetclient.h \
+    $$PWD/stylesheetbundlereader.h
+
+SOURCES += \
+    $$PWD/stylesheetclient.cpp \
+    $$PWD/stylesheetbundlereader.cpp
@@ -0,0 +1,12 @@
+#-------------------------------------------------
+#
+# The style sheet client library, which applies the style sheets published by Qttitude in a running application.
+#
+#-------------------------------------------------
+
+CONFIG += c++14 staticlib
+
+TARGET = stylesheetclient
+TEMPLATE = lib
+
+include(stylesheetclient.pri)
@@ -0,0 +1,301 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 George Sithole
+** Contact: http://www.geovariant.com/qttitude/
+**
+** This is free software distributed under the terms of the GNU General Public License, GPL v3.
+**
+** "Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are
+** met:
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in
+**     the documentation and/or other materials provided with the
+**     distribution.
+**   * Neither the name of Qttitude nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+**
+****************************************************************************/
+
+#ifndef STYLESHEETPROTOCOL_H
+#define STYLESHEETPROTOCOL_H
+
+// Qt Libraries
+#include <QAtomicInt>
+#include <QDataStream>
+#include <QHash>
+#include <QIODevice>
+#include <QObject>
+#include <QString>
+#include <QVector>
+
+
+/**
+ * The version of the protocol between the style sheet server and its clients. A client only talks to a server of the
+ * same version. The version changes whenever a segment layout or a message changes.
+ */
+const quint32 StyleSheetProtocolVersion = 2;
+
+/**
+ * @brief The StyleSheetControlHeader struct is the content of the "StyleSheetSharedMemory" segment. It contains the
+ * generation of the segment the style sheets are published in. A segment of a new generation is created when the style
+ * sheet outgrows the slots, so a segment never changes size while the clients are attached to it.
+ */
+struct StyleSheetControlHeader
+{
+    QBasicAtomicInteger<quint32> generation; // 0 until the first style sheet is published
+    quint32 version; // the protocol version of the server
+};
+
+/**
+ * @brief The StyleSheetSlot struct is at the start of a slot of the style sheet segment, and is followed by the style
+ * sheet in UTF-8. The sequence number is 0 while the server writes the slot.
+ *
+ * The slot also describes the change from the style sheet of the base sequence number: the rule blocks from the
+ * character offset to the offset plus the removed characters are replaced. The new blocks are read from the style
+ * sheet of the slot at the byte offset. A client with the base style sheet reads only the new blocks.
+ *
+ * The edit time is the time of the edit the style sheet was generated for, in milliseconds since the epoch. The clients
+ * run on the same machine as the server, so they measure their latencies from it.
+ */
+struct StyleSheetSlot
+{
+    QBasicAtomicInteger<quint32> sequence;
+    quint32 size; // the number of bytes of the style sheet
+    quint32 checksum; // the qChecksum of the style sheet
+    quint32 base_sequence; // 0 if the slot has no change
+    quint32 char_offset;
+    quint32 char_removed;
+    quint32 byte_offset;
+    quint32 byte_inserted;
+    quint32 delta_checksum; // the qChecksum of the new blocks
+    quint32 reserved;
+    qint64 edit_time;
+};
+
+/**
+ * @brief The StyleSheetSegmentHeader struct is at the start of the style sheet segment, and is followed by its slots.
+ *
+ * The server writes a style sheet into a slot other than the published one, and then publishes the slot index and the
+ * sequence number. A client reads the published slot without a lock, and tests that the sequence number of the slot
+ * did not change while it was read. With three slots the server overwrites a slot only two publications after it was
+ * published, so the clients almost never have to read a slot again.
+ */
+struct StyleSheetSegmentHeader
+{
+    static const int SlotCount = 3;
+
+    QBasicAtomicInteger<quint32> sequence; // the sequence number of the published slot, and 0 before a publication
+    QBasicAtomicInteger<quint32> published; // the index of the published slot
+    quint32 capacity; // the number of bytes of a style sheet a slot holds, a multiple of 8
+    quint32 reserved;
+
+    static QString key(const quint32& generation) {return QString("StyleSheetSharedMemory-%0").arg(generation);}
+
+    static int segmentSize(const quint32& capacity)
+    {
+        return int(sizeof(StyleSheetSegmentHeader) + SlotCount * (sizeof(StyleSheetSlot) + capacity));
+    }
+
+    StyleSheetSlot* slot(const quint32& i)
+    {
+        return (StyleSheetSlot*)((char*)(this + 1) + i * (sizeof(StyleSheetSlot) + capacity));
+    }
+
+    const StyleSheetSlot* slot(const quint32& i) const
+    {
+        return (const StyleSheetSlot*)((const char*)(this + 1) + i * (sizeof(StyleSheetSlot) + capacity));
+    }
+};
+
+/**
+ * @brief The StyleSheetMessage enum contains the types of the messages a client sends to the server. A message is
+ * written with QDataStream (Qt_5_0) as its type (quint8) followed by its fields:
+ * - RegisterMessage: the protocol version (quint32), the process id (qint64) and the application name (QString).
+ * - AcknowledgeMessage: the sequence number (quint32) of the style sheet the client has applied, and the time it took
+ *   to apply it in microseconds (quint32).
+ * - ObjectTreeMessage: an object tree (QByteArray) written by StyleSheetObjectTreeWriter. It replaces the objects
+ *   published before.
+ * - AddObjectMessage: the id (quint64) and the parent id (quint64) of an object, its object name (QString) and its
+ *   class name (QString). The parent id of the root object is 0.
+ * - RemoveObjectMessage: the id (quint64) of an object. The object and its descendants are removed.
+ * - LatencyMessage: the sequence number (quint32) of an applied style sheet, its edit time (qint64), the time the
+ *   client read it (qint64), the time it took to apply it in microseconds (quint32), and the time of the first paint
+ *   after it was applied (qint64). The times are in milliseconds since the epoch. The paint time is 0 if nothing was
+ *   painted within StyleSheetClient::PaintTimeout, or before the next style sheet was applied.
+ */
+enum StyleSheetMessage
+{
+    RegisterMessage = 1,
+    AcknowledgeMessage = 2,
+    ObjectTreeMessage = 3,
+    AddObjectMessage = 4,
+    RemoveObjectMessage = 5,
+    LatencyMessage = 6
+};
+
+/**
+ * @brief The StyleSheetObjectTreeNode struct contains an object of an object tree. The names are shared with the
+ * string table of the tree.
+ */
+struct StyleSheetObjectTreeNode
+{
+    quint64 id = 0;
+    qint32 parent = -1; // the index of the parent node, and -1 for the root node
+    QString name;
+    QString class_name;
+};
+
+/**
+ * @brief The StyleSheetObjectTreeWriter class writes an object tree in a compact binary format. The format is the magic
+ * number and the version, followed by records that start with a tag (quint8):
+ * - 'S': a string, written as its length (quint32) and UTF-8 bytes. The strings are numbered from 0.
+ * - 'N': a node, written as the object id (quint64), the parent node index (qint32), and the string indexes of the
+ *   object name and the class name (quint32). The nodes are numbered from 0, and a parent is written before its
+ *   children.
+ * - 'E': the end of the tree.
+ * A string is written once, before the first node that uses it, so the tree is written and read in one pass.
+ */
+class StyleSheetObjectTreeWriter
+{
+public:
+    static const quint32 Magic = 0x51544f54; // "QTOT"
+
+    static const quint32 Version = 1;
+
+    explicit StyleSheetObjectTreeWriter(QDataStream& out) : m_out(out), m_count(0)
+    {
+        m_out << Magic << Version;
+    }
+
+    /** This member function writes an object and returns its node index.
+     */
+    qint32 writeNode(QObject* object, const qint32& parent)
+    {
+        quint32 name = this->writeString(object->objectName());
+        quint32 class_name = this->writeString(QString(object->metaObject()->className()));
+        m_out << quint8('N') << quint64(quintptr(object)) << parent << name << class_name;
+        return m_count++;
+    }
+
+    /** This member function writes an object and its descendants.
+     */
+    void writeTree(QObject* object, const qint32& parent = -1)
+    {
+        qint32 index = this->writeNode(object, parent);
+        for(QObject* child: object->children())
+            this->writeTree(child, index);
+    }
+
+    void finish()
+    {
+        m_out << quint8('E');
+    }
+
+protected:
+    quint32 writeString(const QString& text)
+    {
+        QHash<QString, quint32>::const_iterator it = m_strings.constFind(text);
+        if(it != m_strings.constEnd())
+            return it.value();
+
+        QByteArray bytes = text.toUtf8();
+        m_out << quint8('S') << quint32(bytes.size());
+        m_out.writeRawData(bytes.constData(), bytes.size());
+
+        quint32 index = quint32(m_strings.count());
+        m_strings.insert(text, index);
+        return index;
+    }
+
+private:
+    QDataStream& m_out;
+
+    QHash<QString, quint32> m_strings;
+
+    qint32 m_count;
+};
+
+/**
+ * @brief The StyleSheetObjectTreeReader class reads the nodes of an object tree one at a time.
+ * See StyleSheetObjectTreeWriter.
+ */
+class StyleSheetObjectTreeReader
+{
+public:
+    explicit StyleSheetObjectTreeReader(QDataStream& in) : m_in(in), m_count(0)
+    {
+        quint32 magic = 0, version = 0;
+        m_in >> magic >> version;
+        m_valid = magic == StyleSheetObjectTreeWriter::Magic && version == StyleSheetObjectTreeWriter::Version;
+    }
+
+    bool isValid() const {return m_valid;}
+
+    /** This member function reads the next node. It returns false at the end of the tree, or if the tree is invalid.
+     */
+    bool readNode(StyleSheetObjectTreeNode& node)
+    {
+        while(m_valid && m_in.status() == QDataStream::Ok)
+        {
+            quint8 tag = 0;
+            m_in >> tag;
+            if(tag == 'S')
+            {
+                quint32 size = 0;
+                m_in >> size;
+                QByteArray bytes(int(qMin(size, quint32(m_in.device() ? m_in.device()->bytesAvailable() : 0))), Qt::Uninitialized);
+                if(m_in.readRawData(bytes.data(), bytes.size()) != int(size))
+                    break;
+                m_strings << QString::fromUtf8(bytes);
+            }
+            else if(tag == 'N')
+            {
+                quint32 name = 0, class_name = 0;
+                m_in >> node.id >> node.parent >> name >> class_name;
+                if(m_in.status() != QDataStream::Ok || name >= quint32(m_strings.count()) ||
+                   class_name >= quint32(m_strings.count()) || node.parent < -1 || node.parent >= m_count)
+                    break;
+                node.name = m_strings.at(int(name));
+                node.class_name = m_strings.at(int(class_name));
+                ++m_count;
+                return true;
+            }
+            else
+            {
+                // the end of the tree
+                m_valid = tag == 'E';
+                return false;
+            }
+        }
+
+        m_valid = false;
+        return false;
+    }
+
+private:
+    QDataStream& m_in;
+
+    QVector<QString> m_strings;
+
+    qint32 m_count;
+
+    bool m_valid;
+};
+
+#endif // STYLESHEETPROTOCOL_H
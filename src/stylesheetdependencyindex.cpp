@@ -0,0 +1,199 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 George Sithole
+** Contact: http://www.geovariant.com/qttitude/
+**
+** This is free software distributed under the terms of the GNU General Public License, GPL v3.
+**
+** "Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are
+** met:
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in
+**     the documentation and/or other materials provided with the
+**     distribution.
+**   * Neither the name of Qttitude nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+**
+****************************************************************************/
+
+// C/C++ Libraries
+#include <algorithm>
+
+// Local Libraries
+#include "stylesheetdependencyindex.h"
+
+
+StyleSheetDependencyIndex::StyleSheetDependencyIndex()
+{
+}
+
+void StyleSheetDependencyIndex::setPageWords(const QString& id, const QSet<QString>& words)
+{
+    this->removePage(id);
+
+    m_page_words[id] = words;
+    for(const QString& word: words)
+        m_word_pages[word].insert(id);
+}
+
+void StyleSheetDependencyIndex::removePage(const QString& id)
+{
+    QHash<QString, QSet<QString>>::iterator iter = m_page_words.find(id);
+    if(iter == m_page_words.end())
+        return;
+
+    for(const QString& word: iter.value())
+    {
+        QHash<QString, QSet<QString>>::iterator page_iter = m_word_pages.find(word);
+        if(page_iter != m_word_pages.end())
+        {
+            page_iter.value().remove(id);
+            if(page_iter.value().isEmpty())
+                m_word_pages.erase(page_iter);
+        }
+    }
+    m_page_words.erase(iter);
+}
+
+QSet<QString> StyleSheetDependencyIndex::pages(const QSet<QString>& names) const
+{
+    QSet<QString> ids;
+    for(const QString& name: names)
+        ids += m_word_pages.value(name);
+    return ids;
+}
+
+void StyleSheetDependencyIndex::setDefinitions(const StyleSheetDefinitions& snippets, const StyleSheetDefinitions& variables)
+{
+    m_references.clear();
+    m_back_references.clear();
+
+    // the position of the last definition of each name
+    StyleSheetDefinitions definitions = snippets + variables;
+    QHash<QString, int> last;
+    for(int i = 0; i < definitions.count(); ++i)
+        last[definitions[i].first.trimmed()] = i;
+
+    QSet<QPair<QString, QString>> back_references;
+    for(int i = 0; i < definitions.count(); ++i)
+    {
+        QString name = definitions[i].first.trimmed();
+        QSet<QString>& references = m_references[name];
+        for(const QString& word: StyleSheetExpander::words(definitions[i].second))
+        {
+            if(!last.contains(word))
+                continue;
+            references << word;
+
+            // the value of a definition is only expanded by the definitions after it
+            if(last[word] <= i)
+                back_references << qMakePair(name, word);
+        }
+    }
+
+    m_back_references = back_references.toList();
+    std::sort(m_back_references.begin(), m_back_references.end());
+}
+
+QList<QStringList> StyleSheetDependencyIndex::cycles() const
+{
+    // find the strongly connected components of the name graph (Tarjan's algorithm)
+    QHash<QString, int> index, low;
+    QStringList stack;
+    QSet<QString> on_stack;
+    QList<QStringList> cycles;
+
+    QStringList names = m_references.keys();
+    names.sort();
+    for(const QString& name: names)
+    {
+        if(!index.contains(name))
+            this->findCycles(name, index, low, stack, on_stack, cycles);
+    }
+    return cycles;
+}
+
+QList<QPair<QString, QString>> StyleSheetDependencyIndex::backReferences() const
+{
+    // the references within a cycle are reported with the cycle
+    QHash<QString, int> groups;
+    QList<QStringList> cycles = this->cycles();
+    for(int i = 0; i < cycles.count(); ++i)
+    {
+        for(const QString& name: cycles[i])
+            groups[name] = i;
+    }
+
+    QList<QPair<QString, QString>> references;
+    for(const QPair<QString, QString>& reference: m_back_references)
+    {
+        if(!groups.contains(reference.first) || groups.value(reference.first) != groups.value(reference.second, -1))
+            references << reference;
+    }
+    return references;
+}
+
+void StyleSheetDependencyIndex::findCycles(const QString& name, QHash<QString, int>& index, QHash<QString, int>& low,
+                                           QStringList& stack, QSet<QString>& on_stack, QList<QStringList>& cycles) const
+{
+    int i = index.count();
+    index[name] = i;
+    low[name] = i;
+    stack << name;
+    on_stack << name;
+
+    for(const QString& reference: m_references.value(name))
+    {
+        if(!index.contains(reference))
+        {
+            this->findCycles(reference, index, low, stack, on_stack, cycles);
+            low[name] = qMin(low[name], low[reference]);
+        }
+        else if(on_stack.contains(reference))
+        {
+            low[name] = qMin(low[name], index[reference]);
+        }
+    }
+
+    // name is the root of a component
+    if(low[name] == index[name])
+    {
+        QStringList component;
+        QString member;
+        do {
+            member = stack.takeLast();
+            on_stack.remove(member);
+            component << member;
+        } while(member != name);
+
+        if(component.count() > 1 || m_references.value(name).contains(name))
+        {
+            component.sort();
+            cycles << component;
+        }
+    }
+}
+
+void StyleSheetDependencyIndex::clear()
+{
+    m_page_words.clear();
+    m_word_pages.clear();
+    m_references.clear();
+    m_back_references.clear();
+}
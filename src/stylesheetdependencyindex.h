@@ -0,0 +1,121 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 George Sithole
+** Contact: http://www.geovariant.com/qttitude/
+**
+** This is free software distributed under the terms of the GNU General Public License, GPL v3.
+**
+** "Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are
+** met:
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in
+**     the documentation and/or other materials provided with the
+**     distribution.
+**   * Neither the name of Qttitude nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+**
+****************************************************************************/
+
+#ifndef STYLESHEETDEPENDENCYINDEX_H
+#define STYLESHEETDEPENDENCYINDEX_H
+
+// Qt Libraries
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QSet>
+#include <QList>
+#include <QPair>
+
+// Local Libraries
+#include "stylesheetexpander.h"
+
+
+/**
+ * @brief The StyleSheetDependencyIndex class
+ *
+ * Records which pages use which words, and which names appear in the value of each snippet and
+ * variable. The index is used to find the pages affected by a change of the definitions, and to
+ * find definitions that refer to each other in a cycle or to an earlier definition.
+ */
+
+class StyleSheetDependencyIndex
+{
+public:
+    StyleSheetDependencyIndex();
+
+    /** This member function sets the words used by a page.
+     */
+    void setPageWords(const QString& id, const QSet<QString>& words);
+
+    /** This member function removes a page from the index.
+     */
+    void removePage(const QString& id);
+
+    /** This member function returns the ids of the pages that use any of the names.
+     */
+    QSet<QString> pages(const QSet<QString>& names) const;
+
+    /** This member function sets the snippets and variables, and rebuilds the name graph.
+     */
+    void setDefinitions(const StyleSheetDefinitions& snippets, const StyleSheetDefinitions& variables);
+
+    /** This member function returns the names of the definitions that appear in the value of a definition.
+     */
+    QSet<QString> references(const QString& name) const {return m_references.value(name);}
+
+    /** This member function returns the groups of definitions that refer to each other. A definition
+     * that refers to itself is a group of one.
+     */
+    QList<QStringList> cycles() const;
+
+    /** This member function returns the definitions whose values refer to a name that is only defined
+     * before them, as pairs of the definition and the name. The expander replaces a name in a value with the
+     * later definitions only, so these names are left as they are. References within a cycle are not returned.
+     */
+    QList<QPair<QString, QString>> backReferences() const;
+
+    /** This member function removes the pages and definitions.
+     */
+    void clear();
+
+protected:
+    void findCycles(const QString& name, QHash<QString, int>& index, QHash<QString, int>& low,
+                    QStringList& stack, QSet<QString>& on_stack, QList<QStringList>& cycles) const;
+
+private:
+    /** This member variable contains the words of each page. The key is the page id.
+     */
+    QHash<QString, QSet<QString>> m_page_words;
+
+    /** This member variable contains the pages that use a word.
+     */
+    QHash<QString, QSet<QString>> m_word_pages;
+
+    /** This member variable contains the names that appear in the value of each definition.
+     */
+    QHash<QString, QSet<QString>> m_references;
+
+    /** This member variable contains the names that appear in the value of a definition but are only
+     * defined before it, sorted by definition and name.
+     */
+    QList<QPair<QString, QString>> m_back_references;
+};
+
+#endif // STYLESHEETDEPENDENCYINDEX_H
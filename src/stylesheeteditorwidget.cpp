@@ -55,6 +55,10 @@
 #include <QJsonArray>
 #include <QJsonObject>
 #include <QListView>
+#include <QThreadPool>
+#include <QFileInfo>
+#include <QDir>
+#include <QDateTime>
 
 
 // Local Libraries
@@ -67,6 +71,9 @@
 #include "dialogcolorspec.h"
 #include "workspace.h"
 #include "dialogpagecreator.h"
+#include "previewscheduler.h"
+#include "qssminifier.h"
+#include "stylesheetbundle.h"
 
 
 
@@ -144,10 +151,27 @@ StyleSheetEditorWidget::StyleSheetEditorWidget(Workspace* workspace, QWidget *pa
 
     // set up the completer
     this->m_completer = Q_NULLPTR;
+
+    // setup the preview scheduler, bursts of edits are coalesced into one preview
+    this->m_preview_scheduler = new PreviewScheduler(this);
+    connect(this->m_preview_scheduler, SIGNAL(updateRequested(quint64)), this, SLOT(processPreviewRequest(quint64)));
+
+    // setup the thread that generates the live preview
+    qRegisterMetaType<StyleSheetGenerationResult>("StyleSheetGenerationResult");
+    this->m_thread_pool = new QThreadPool(this);
+    this->m_thread_pool->setMaxThreadCount(1);
+    this->m_generation_revision = 0;
+    this->m_generation_edit_time = 0;
+    this->m_edit_time = 0;
 }
 
 StyleSheetEditorWidget::~StyleSheetEditorWidget()
 {
+    // stop the generation in progress before the widget is destroyed
+    if(this->m_generation_cancel)
+        this->m_generation_cancel->storeRelease(1);
+    this->m_thread_pool->waitForDone();
+
     delete ui;
 }
 
@@ -155,79 +179,133 @@ void StyleSheetEditorWidget::setLivePreview(const bool& state)
 {
     this->m_live_preview = state;
     if(this->m_live_preview) {
-        emit this->styleSheetReady(this->generateStyleSheet());
+        this->m_preview_scheduler->request();
     }
 }
 
+void StyleSheetEditorWidget::setPreviewLatency(const int& msec)
+{
+    this->m_preview_scheduler->setLatency(msec);
+}
+
+void StyleSheetEditorWidget::processPreviewRequest(quint64 revision)
+{
+    if(!this->m_live_preview)
+        return;
+
+    // cancel the generation in progress, its result is superseded
+    if(this->m_generation_cancel)
+        this->m_generation_cancel->storeRelease(1);
+
+    // generate the style sheet from a copy of the pages and definitions on a worker thread
+    this->m_generation_cancel = QSharedPointer<QAtomicInt>(new QAtomicInt(0));
+    this->m_generation_revision = revision;
+    this->m_generation_edit_time = this->m_preview_scheduler->requestTime();
+    StyleSheetGenerationTask* task = new StyleSheetGenerationTask(this, revision, this->snapshot(),
+                                                                  this->m_page_cache, this->m_generation_cancel);
+    this->m_thread_pool->start(task);
+}
+
+void StyleSheetEditorWidget::processGenerationFinished(StyleSheetGenerationResult result)
+{
+    // ignore the results of superseded generations
+    if(result.revision != this->m_generation_revision)
+        return;
+
+    // keep the pages expanded by the worker
+    this->m_page_cache = result.cache;
+    this->reportCycles();
+
+    // skip the preview if it was cancelled or a newer request is pending, it will be generated next
+    if(result.cancelled || !this->m_live_preview || this->m_preview_scheduler->isStale(result.revision))
+        return;
+
+    this->m_edit_time = this->m_generation_edit_time;
+    emit this->styleSheetReady(result.style_sheet);
+}
+
 QString StyleSheetEditorWidget::generateStyleSheet()
 {
-    // combine the text from the pages
-    QString text;
+    QString style_sheet = StyleSheetGenerationTask::generate(this->snapshot(), this->m_page_cache);
+    this->reportCycles();
+    return style_sheet;
+}
+
+StyleSheetSnapshot StyleSheetEditorWidget::snapshot()
+{
+    StyleSheetSnapshot snapshot;
+    snapshot.snippets = this->definitions(m_snippet_model);
+    snapshot.variables = this->definitions(m_vars_model);
+
     for(int i = 0; i < m_page_model->rowCount(); ++i)
     {
         QStandardItem* page_item = m_page_model->item(i, 0);
         QStandardItem* qss_item = m_page_model->item(i, 1);
-        QString page_name = page_item->text();
         if(page_item->checkState() == Qt::Checked)
         {
-            QString id = page_item->data(Qt::UserRole + 1).toString();
-            text += QString("/* %0 */\n\n%1\n\n").arg(page_name).arg(qss_item->text());
+            StyleSheetPage page;
+            page.id = page_item->data(Qt::UserRole + 1).toString();
+            page.name = page_item->text();
+            page.qss = qss_item->text();
+            snapshot.pages << page;
         }
     }
+    return snapshot;
+}
 
-    // replace snippet names with the snippet value
-    for(int i = 0; i < m_snippet_model->rowCount(); ++i)
+void StyleSheetEditorWidget::reportCycles()
+{
+    // report snippets and variables that refer to each other
+    QList<QStringList> cycles = m_page_cache.cycles();
+    if(cycles != m_cycles)
     {
-        QString snippet_name = m_snippet_model->index(i, 0).data(Qt::DisplayRole).toString().trimmed();
-        QString snippet_value = m_snippet_model->index(i, 1).data(Qt::DisplayRole).toString().trimmed();
-
-        // replace variable name with variable value
-        QRegExp reg_exp(QString("\\b%0\\b").arg(snippet_name));
-        text = text.replace(reg_exp, snippet_value);
+        m_cycles = cycles;
+        if(!cycles.isEmpty())
+        {
+            QStringList groups;
+            for(const QStringList& cycle: cycles)
+                groups << cycle.join(" <-> ");
+            emit this->styleSheetWarning(tr("Circular references are only partly expanded: %0").arg(groups.join(", ")));
+        }
     }
 
-    // replace variable names with variable value
-    for(int i = 0; i < m_vars_model->rowCount(); ++i)
+    // report snippets and variables that refer to earlier definitions, the names are not replaced in their values
+    QList<QPair<QString, QString>> back_references = m_page_cache.backReferences();
+    if(back_references != m_back_references)
     {
-        QString var_name = m_vars_model->index(i, 0).data(Qt::DisplayRole).toString().trimmed();
-        QString var_value = m_vars_model->index(i, 1).data(Qt::DisplayRole).toString().trimmed();
-
-        // replace variable name with variable value
-        QRegExp reg_exp(QString("\\b%0\\b").arg(var_name));
-        text = text.replace(reg_exp, var_value);
+        m_back_references = back_references;
+        if(!back_references.isEmpty())
+        {
+            QStringList references;
+            for(const QPair<QString, QString>& reference: back_references)
+                references << reference.first + " -> " + reference.second;
+            emit this->styleSheetWarning(tr("References to earlier snippets and variables are not expanded: %0").arg(references.join(", ")));
+        }
     }
-
-    return text.trimmed();
 }
 
-QString StyleSheetEditorWidget::replaceWithSnippet(const QString& text)
+StyleSheetDefinitions StyleSheetEditorWidget::definitions(QStandardItemModel* model)
 {
-    QString local_text = text;
-    for(int i = 0; i < m_snippet_model->rowCount(); ++i)
+    StyleSheetDefinitions defs;
+    for(int i = 0; i < model->rowCount(); ++i)
     {
-        QString snippet_name = m_snippet_model->index(i, 0).data(Qt::DisplayRole).toString().trimmed();
-        QString snippet_value = m_snippet_model->index(i, 1).data(Qt::DisplayRole).toString().trimmed();
-
-        // replace variable name with variable value
-        QRegExp reg_exp(QString("\\b%0\\b").arg(snippet_name));
-        local_text = local_text.replace(reg_exp, snippet_value);
+        QString name = model->index(i, 0).data(Qt::DisplayRole).toString();
+        QString value = model->index(i, 1).data(Qt::DisplayRole).toString();
+        defs << StyleSheetDefinition(name, value);
     }
-    return local_text;
+    return defs;
 }
 
-QString StyleSheetEditorWidget::replaceWithVariables(const QString& text)
+QString StyleSheetEditorWidget::replaceWithSnippet(const QString& text)
 {
-    QString local_text = text;
-    for(int i = 0; i < m_vars_model->rowCount(); ++i)
-    {
-        QString var_name = m_vars_model->index(i, 0).data(Qt::DisplayRole).toString().trimmed();
-        QString var_value = m_vars_model->index(i, 1).data(Qt::DisplayRole).toString().trimmed();
+    StyleSheetExpander expander(this->definitions(m_snippet_model), StyleSheetDefinitions());
+    return expander.expand(text);
+}
 
-        // replace variable name with variable value
-        QRegExp reg_exp(QString("\\b%0\\b").arg(var_name));
-        local_text = local_text.replace(reg_exp, var_value);
-    }
-    return local_text;
+QString StyleSheetEditorWidget::replaceWithVariables(const QString& text)
+{
+    StyleSheetExpander expander(StyleSheetDefinitions(), this->definitions(m_vars_model));
+    return expander.expand(text);
 }
 
 void StyleSheetEditorWidget::on_btnAddVar_clicked()
@@ -343,7 +421,7 @@ void StyleSheetEditorWidget::processTextChanged()
 
     if(this->m_live_preview)
     {
-        emit this->styleSheetReady(this->generateStyleSheet());
+        this->m_preview_scheduler->request();
     }
 }
 
@@ -441,7 +519,7 @@ void StyleSheetEditorWidget::addPagesFromJson(const QJsonValue& snippets_value)
     }
 }
 
-bool StyleSheetEditorWidget::saveStyleSheet(const QString& filename)
+bool StyleSheetEditorWidget::saveStyleSheet(const QString& filename, const bool& minify)
 {
 //    QString qssfilename = QString("%0.qss").arg(QFileInfo(m_filename).baseName());
 //    this->saveStyleSheet(qssfilename);
@@ -462,7 +540,8 @@ bool StyleSheetEditorWidget::saveStyleSheet(const QString& filename)
     QFile file(local_filename);
     if(file.open(QIODevice::WriteOnly | QIODevice::Text))
     {
-        file.write(this->generateStyleSheet().toLatin1());
+        QString style_sheet = this->generateStyleSheet();
+        file.write((minify ? QssMinifier::minify(style_sheet) : style_sheet).toLatin1());
         return true;
     } else {
         qDebug() << "Error: saveStyleSheet. Failed to save file " << local_filename;
@@ -473,6 +552,51 @@ bool StyleSheetEditorWidget::saveStyleSheet(const QString& filename)
     return false;
 }
 
+bool StyleSheetEditorWidget::saveStyleSheetBundle(const QMap<QString, QWidget*>& forms)
+{
+    if(this->m_qss_filename.isEmpty()) {
+        qDebug() << "Error: saveStyleSheetBundle. No style sheet filename";
+        return false;
+    }
+
+    // the applications look the sections up by the file names of the forms, so they must be unique
+    QMap<QString, QWidget*> named_forms;
+    QMap<QString, QWidget*>::const_iterator it = forms.constBegin();
+    for(; it != forms.constEnd(); ++it)
+    {
+        QString name = QFileInfo(it.key()).fileName();
+        if(named_forms.contains(name)) {
+            qDebug() << "Error: saveStyleSheetBundle. More than one form is named " << name;
+            emit this->styleSheetWarning(tr("The bundle is not exported, more than one form is named %0").arg(name));
+            return false;
+        }
+        named_forms[name] = it.value();
+    }
+
+    QFileInfo info(this->m_qss_filename);
+    QString basename = info.dir().filePath(info.completeBaseName());
+    QList<StyleSheetBundleSection> sections = StyleSheetBundle::sections(this->generateStyleSheet(), named_forms);
+
+    // save the binary bundle
+    QFile bundle_file(basename + ".qssb");
+    if(!bundle_file.open(QIODevice::WriteOnly) || !StyleSheetBundle::write(sections, &bundle_file)) {
+        qDebug() << "Error: saveStyleSheetBundle. Failed to save file " << bundle_file.fileName();
+        return false;
+    }
+    bundle_file.close();
+
+    // save the C++ header
+    QFile header_file(basename + "_bundle.h");
+    if(!header_file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        qDebug() << "Error: saveStyleSheetBundle. Failed to save file " << header_file.fileName();
+        return false;
+    }
+    header_file.write(StyleSheetBundle::generateHeader(sections, info.completeBaseName()).toLatin1());
+    header_file.close();
+
+    return true;
+}
+
 
 void StyleSheetEditorWidget::on_btnClear_clicked()
 {
@@ -520,7 +644,7 @@ void StyleSheetEditorWidget::processVarsModelDataChanged(const QModelIndex &topL
 
         // generate a style sheet if the live preview is on
         if(m_live_preview)
-            emit this->styleSheetReady(this->generateStyleSheet());
+            this->m_preview_scheduler->request();
     }
     // ... when the color changes
     else if(topLeft.column() == 1)
@@ -577,7 +701,7 @@ void StyleSheetEditorWidget::processSnippetModelDataChanged(const QModelIndex &t
 
         // generate a style sheet if the live preview is on
         if(m_live_preview)
-            emit this->styleSheetReady(this->generateStyleSheet());
+            this->m_preview_scheduler->request();
     }
     // ... when the color changes
     else if(topLeft.column() == 1)
@@ -596,6 +720,10 @@ void StyleSheetEditorWidget::processSnippetModelDataChanged(const QModelIndex &t
 
 void StyleSheetEditorWidget::on_btnApplyStyleSheet_clicked()
 {
+    // the style sheet is applied now, so a pending preview is not needed
+    this->m_preview_scheduler->cancel();
+
+    this->m_edit_time = QDateTime::currentMSecsSinceEpoch();
     QString ss = this->generateStyleSheet();
     emit this->styleSheetReady(ss);
 }
@@ -633,7 +761,7 @@ void StyleSheetEditorWidget::on_btnRemovePage_clicked()
 
     // apply if live is true
     if(this->m_live_preview) {
-        emit this->styleSheetReady(this->generateStyleSheet());
+        this->m_preview_scheduler->request();
     }
 }
 
@@ -653,7 +781,7 @@ void StyleSheetEditorWidget::on_btnPageUp_clicked()
 
     // generate a style sheet if the live preview is on
     if(m_live_preview)
-        emit this->styleSheetReady(this->generateStyleSheet());
+        this->m_preview_scheduler->request();
 }
 
 void StyleSheetEditorWidget::on_btnPageDown_clicked()
@@ -672,7 +800,7 @@ void StyleSheetEditorWidget::on_btnPageDown_clicked()
 
     // generate a style sheet if the live preview is on
     if(m_live_preview)
-        emit this->styleSheetReady(this->generateStyleSheet());
+        this->m_preview_scheduler->request();
 }
 
 void StyleSheetEditorWidget::on_treeViewPage_clicked(const QModelIndex &index)
@@ -685,7 +813,7 @@ void StyleSheetEditorWidget::on_treeViewPage_clicked(const QModelIndex &index)
 
     // generate a style sheet if the live preview is on
     if(m_live_preview)
-        emit this->styleSheetReady(this->generateStyleSheet());
+        this->m_preview_scheduler->request();
 }
 
 void StyleSheetEditorWidget::setupCompleter()
@@ -1118,7 +1246,7 @@ void StyleSheetEditorWidget::on_btnRandomShuffle_clicked()
     // apply if live is true
     if(this->m_live_preview)
     {
-        emit this->styleSheetReady(this->generateStyleSheet());
+        this->m_preview_scheduler->request();
     }
 }
 
@@ -1239,7 +1367,7 @@ void StyleSheetEditorWidget::generateRandomColorScheme()
     // apply if live is true
     if(this->m_live_preview)
     {
-        emit this->styleSheetReady(this->generateStyleSheet());
+        this->m_preview_scheduler->request();
     }
 }
 
@@ -1252,7 +1380,7 @@ void StyleSheetEditorWidget::on_comboBoxOrdering_activated(const QString &arg1)
     // apply if live is true
     if(this->m_live_preview)
     {
-        emit this->styleSheetReady(this->generateStyleSheet());
+        this->m_preview_scheduler->request();
     }
 }
 
@@ -1354,6 +1482,13 @@ void StyleSheetEditorWidget::reset()
     this->m_snippet_model->setHeaderData(1, Qt::Horizontal, "Value");
 
     this->m_page_model->clear();
+    this->m_page_cache.clear();
+    this->m_preview_scheduler->cancel();
+    if(this->m_generation_cancel)
+        this->m_generation_cancel->storeRelease(1);
+    this->m_generation_revision = 0;
+    this->m_cycles.clear();
+    this->m_back_references.clear();
     this->m_page_model->setColumnCount(2);
     this->m_page_model->setHeaderData(0, Qt::Horizontal, "Page");
     this->m_page_model->setHeaderData(1, Qt::Horizontal, "Style sheet");
@@ -37,8 +37,14 @@
 
 // Qt Libraries
 #include <QWidget>
+#include <QSharedPointer>
+#include <QAtomicInt>
+#include <QMap>
 
 // Local Libraries
+#include "stylesheetexpander.h"
+#include "stylesheetpagecache.h"
+#include "stylesheetgenerationtask.h"
 
 
 class QStandardItemModel;
@@ -46,10 +52,12 @@ class QStandardItem;
 class QCompleter;
 class QStringListModel;
 class QMainWindow;
+class QThreadPool;
 
 class Highlighter;
 class TextEditor;
 class Workspace;
+class PreviewScheduler;
 
 
 namespace Ui {
@@ -68,7 +76,16 @@ public:
     enum SchemeOrder{Reverse_Ordering, HSV_Ordering, HVS_Ordering, SVH_Ordering,
                      SHV_Ordering, VHS_Ordering, VSH_Ordering, Random_Ordering};
 
-    bool saveStyleSheet(const QString& filename = "");
+    /** This member function writes the generated style sheet. A minified style sheet has no comments or white space,
+     * and no rules or declarations that do not change its styling.
+     */
+    bool saveStyleSheet(const QString& filename = "", const bool& minify = false);
+
+    /** This member function writes the style sheet bundle of the forms next to the style sheet file, as a binary bundle
+     * (.qssb) and as a C++ header (_bundle.h). See StyleSheetBundle. The key of a form is the path of its .ui file,
+     * and the sections are named by the file name. Forms with the same file name are not written.
+     */
+    bool saveStyleSheetBundle(const QMap<QString, QWidget*>& forms);
 
     QString styleSheetFilename(){return this->m_qss_filename;}
 
@@ -94,13 +111,27 @@ public:
 
     QString generateStyleSheet();
 
+    /** This member function sets the longest delay, in milliseconds, between an edit and its live preview.
+     */
+    void setPreviewLatency(const int& msec);
+
+    /** This member function returns the time of the edit the last style sheet emitted by styleSheetReady() was
+     * generated for, in milliseconds since the epoch.
+     */
+    qint64 styleSheetEditTime() const {return m_edit_time;}
+
 signals:
     void styleSheetReady(QString);
 
+    void styleSheetWarning(QString);
+
 public slots:
     void setLivePreview(const bool& state);
 
 private slots:
+    void processPreviewRequest(quint64 revision);
+
+    void processGenerationFinished(StyleSheetGenerationResult result);
 
     void on_btnAddVar_clicked();
 
@@ -182,6 +213,12 @@ protected:
 
     bool eventFilter(QObject* obj, QEvent* event);
 
+    StyleSheetDefinitions definitions(QStandardItemModel* model);
+
+    StyleSheetSnapshot snapshot();
+
+    void reportCycles();
+
     QString replaceWithSnippet(const QString& text);
     QString replaceWithVariables(const QString& text);
 
@@ -194,6 +231,12 @@ private:
 
     QStandardItemModel* m_page_model;
 
+    StyleSheetPageCache m_page_cache;
+
+    QList<QStringList> m_cycles;
+
+    QList<QPair<QString, QString>> m_back_references;
+
     QStringListModel* m_completer_model;
 
     Highlighter* m_highlihter;
@@ -204,6 +247,24 @@ private:
 
     bool m_live_preview;
 
+    PreviewScheduler* m_preview_scheduler;
+
+    /** This member variable runs the live preview generation off the GUI thread.
+     */
+    QThreadPool* m_thread_pool;
+
+    /** This member variable is the cancel flag of the latest generation.
+     */
+    QSharedPointer<QAtomicInt> m_generation_cancel;
+
+    quint64 m_generation_revision;
+
+    /** This member variable contains the edit time of the latest generation, and of the last style sheet emitted.
+     */
+    qint64 m_generation_edit_time;
+
+    qint64 m_edit_time;
+
     QCompleter* m_completer;
 
     TextEditor* m_text_editor;
@@ -0,0 +1,208 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 George Sithole
+** Contact: http://www.geovariant.com/qttitude/
+**
+** This is free software distributed under the terms of the GNU General Public License, GPL v3.
+**
+** "Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are
+** met:
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in
+**     the documentation and/or other materials provided with the
+**     distribution.
+**   * Neither the name of Qttitude nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+**
+****************************************************************************/
+
+// Qt Libraries
+#include <QRegExp>
+
+// Local Libraries
+#include "stylesheetexpander.h"
+
+
+StyleSheetExpander::StyleSheetExpander() :
+    m_sequential(false)
+{
+}
+
+StyleSheetExpander::StyleSheetExpander(const StyleSheetDefinitions& snippets, const StyleSheetDefinitions& variables) :
+    m_sequential(false)
+{
+    // snippets are replaced before variables
+    for(const StyleSheetDefinition& d: snippets)
+        m_definitions << StyleSheetDefinition(d.first.trimmed(), d.second.trimmed());
+    for(const StyleSheetDefinition& d: variables)
+        m_definitions << StyleSheetDefinition(d.first.trimmed(), d.second.trimmed());
+
+    this->compile();
+}
+
+bool StyleSheetExpander::isWordName(const QString& name)
+{
+    if(name.isEmpty())
+        return false;
+
+    for(const QChar& c: name)
+    {
+        if(!StyleSheetExpander::isWordCharacter(c))
+            return false;
+    }
+    return true;
+}
+
+QSet<QString> StyleSheetExpander::words(const QString& text)
+{
+    QSet<QString> words;
+    int start = -1;
+    for(int i = 0; i <= text.length(); ++i)
+    {
+        bool is_word = i < text.length() && StyleSheetExpander::isWordCharacter(text[i]);
+        if(is_word && start < 0)
+        {
+            start = i;
+        }
+        else if(!is_word && start >= 0)
+        {
+            words << text.mid(start, i - start);
+            start = -1;
+        }
+    }
+    return words;
+}
+
+void StyleSheetExpander::compile()
+{
+    // build the name lookup table
+    for(int i = 0; i < m_definitions.count(); ++i)
+    {
+        const QString& name = m_definitions[i].first;
+        if(!StyleSheetExpander::isWordName(name))
+        {
+            // a name such as "@color" or "a.b" is matched by the regular expression in ways
+            // a word lookup cannot reproduce, so keep the original behaviour for the project
+            m_sequential = true;
+            m_lookup.clear();
+            return;
+        }
+        m_lookup[name] << i;
+    }
+
+    // expand the values from the last definition to the first. a value can only be changed
+    // by the definitions that are replaced after it, which have already been expanded
+    m_expanded.resize(m_definitions.count());
+    for(int i = m_definitions.count() - 1; i >= 0; --i)
+    {
+        QString value;
+        this->expandFrom(m_definitions[i].second, i + 1, value);
+        m_expanded[i] = value;
+    }
+}
+
+QString StyleSheetExpander::expand(const QString& text, QSet<QString>* words) const
+{
+    if(m_sequential)
+        return this->expandSequentially(text);
+
+    QString out;
+    out.reserve(text.size());
+    this->expandFrom(text, 0, out, words);
+    return out;
+}
+
+bool StyleSheetExpander::resolve(const QString& name, QString* value) const
+{
+    if(m_sequential)
+        return false;
+
+    int index = this->lookup(name, 0);
+    if(index < 0)
+        return false;
+
+    if(value != nullptr)
+        *value = m_expanded[index];
+    return true;
+}
+
+int StyleSheetExpander::lookup(const QString& word, const int& first) const
+{
+    QHash<QString, QVector<int>>::const_iterator iter = m_lookup.constFind(word);
+    if(iter == m_lookup.constEnd())
+        return -1;
+
+    for(int index: iter.value())
+    {
+        if(index >= first)
+            return index;
+    }
+    return -1;
+}
+
+void StyleSheetExpander::expandFrom(const QString& text, const int& first, QString& out, QSet<QString>* words) const
+{
+    if(m_lookup.isEmpty() && words == nullptr)
+    {
+        out += text;
+        return;
+    }
+
+    const QChar* data = text.constData();
+    const int length = text.length();
+
+    int i = 0;
+    while(i < length)
+    {
+        // copy everything up to the next word
+        int start = i;
+        while(i < length && !StyleSheetExpander::isWordCharacter(data[i]))
+            ++i;
+        if(i > start)
+            out.append(data + start, i - start);
+
+        // read the word
+        start = i;
+        while(i < length && StyleSheetExpander::isWordCharacter(data[i]))
+            ++i;
+        if(i > start)
+        {
+            const QString word = QString::fromRawData(data + start, i - start);
+            if(words != nullptr && !words->contains(word))
+                words->insert(QString(data + start, i - start)); // a deep copy, the raw data belongs to text
+            int index = this->lookup(word, first);
+            if(index >= 0)
+                out += m_expanded[index];
+            else
+                out.append(data + start, i - start);
+        }
+    }
+}
+
+QString StyleSheetExpander::expandSequentially(const QString& text) const
+{
+    QString local_text = text;
+    for(const StyleSheetDefinition& d: m_definitions)
+    {
+        // replace name with value
+        QRegExp reg_exp(QString("\\b%0\\b").arg(d.first));
+        local_text = local_text.replace(reg_exp, d.second);
+    }
+    return local_text;
+}
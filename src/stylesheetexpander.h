@@ -0,0 +1,126 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 George Sithole
+** Contact: http://www.geovariant.com/qttitude/
+**
+** This is free software distributed under the terms of the GNU General Public License, GPL v3.
+**
+** "Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are
+** met:
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in
+**     the documentation and/or other materials provided with the
+**     distribution.
+**   * Neither the name of Qttitude nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+**
+****************************************************************************/
+
+#ifndef STYLESHEETEXPANDER_H
+#define STYLESHEETEXPANDER_H
+
+// Qt Libraries
+#include <QString>
+#include <QList>
+#include <QPair>
+#include <QHash>
+#include <QVector>
+#include <QSet>
+
+
+typedef QPair<QString, QString> StyleSheetDefinition; // name, value
+typedef QList<StyleSheetDefinition> StyleSheetDefinitions;
+
+
+/**
+ * @brief The StyleSheetExpander class
+ *
+ * Replaces snippet and variable names in a style sheet with their values. The snippets are
+ * applied first and then the variables, each in model order, exactly as a sequence of
+ * QRegExp("\\bname\\b") replacements would. Instead of rescanning the text once per name, the
+ * expander resolves each word of the text through a hash table in a single pass. The value of
+ * every definition is expanded once, up front, against the definitions that follow it.
+ */
+
+class StyleSheetExpander
+{
+public:
+    StyleSheetExpander();
+
+    StyleSheetExpander(const StyleSheetDefinitions& snippets, const StyleSheetDefinitions& variables);
+
+    /** This member function returns the text with the snippet and variable names replaced by their values.
+     * If words is not null, every word of the text is added to it.
+     */
+    QString expand(const QString& text, QSet<QString>* words = nullptr) const;
+
+    /** This member function returns true if a word with the name is replaced, and sets value to the replacement.
+     */
+    bool resolve(const QString& name, QString* value = nullptr) const;
+
+    /** This member function returns true if the expander falls back to sequential replacement.
+     */
+    bool isSequential() const {return m_sequential;}
+
+    /** This member function returns the names of the definitions.
+     */
+    QList<QString> names() const {return m_lookup.keys();}
+
+    /** This member function returns true if the character is part of a word (as matched by \\b).
+     */
+    static bool isWordCharacter(const QChar& c)
+    { return c.isLetterOrNumber() || c.isMark() || c == QLatin1Char('_'); }
+
+    /** This member function returns true if the name consists of word characters only.
+     */
+    static bool isWordName(const QString& name);
+
+    /** This member function returns the words of the text.
+     */
+    static QSet<QString> words(const QString& text);
+
+protected:
+    void compile();
+
+    void expandFrom(const QString& text, const int& first, QString& out, QSet<QString>* words = nullptr) const;
+
+    int lookup(const QString& word, const int& first) const;
+
+    QString expandSequentially(const QString& text) const;
+
+private:
+    /** This member variable contains the snippets followed by the variables, in replacement order.
+     */
+    QVector<StyleSheetDefinition> m_definitions;
+
+    /** This member variable contains the expanded value of each definition.
+     */
+    QVector<QString> m_expanded;
+
+    /** This member variable maps a name to the ascending indices of its definitions.
+     */
+    QHash<QString, QVector<int>> m_lookup;
+
+    /** This member variable is true if a name is not a plain word and the expander must
+     * fall back to sequential regular expression replacement.
+     */
+    bool m_sequential;
+};
+
+#endif // STYLESHEETEXPANDER_H
@@ -0,0 +1,99 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 George Sithole
+** Contact: http://www.geovariant.com/qttitude/
+**
+** This is free software distributed under the terms of the GNU General Public License, GPL v3.
+**
+** "Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are
+** met:
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in
+**     the documentation and/or other materials provided with the
+**     distribution.
+**   * Neither the name of Qttitude nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+**
+****************************************************************************/
+
+// Qt Libraries
+#include <QObject>
+#include <QMetaObject>
+#include <QSet>
+
+// Local Libraries
+#include "stylesheetgenerationtask.h"
+
+
+StyleSheetGenerationTask::StyleSheetGenerationTask(QObject* receiver, const quint64& revision,
+                                                   const StyleSheetSnapshot& snapshot,
+                                                   const StyleSheetPageCache& cache,
+                                                   QSharedPointer<QAtomicInt> cancel) :
+    m_receiver(receiver),
+    m_revision(revision),
+    m_snapshot(snapshot),
+    m_cache(cache),
+    m_cancel(cancel)
+{
+    this->setAutoDelete(true);
+}
+
+void StyleSheetGenerationTask::run()
+{
+    StyleSheetGenerationResult result;
+    result.revision = m_revision;
+    result.style_sheet = StyleSheetGenerationTask::generate(m_snapshot, m_cache, m_cancel.data(), &result.cancelled);
+    result.cache = m_cache;
+
+    // hand the result back to the thread of the receiver
+    QMetaObject::invokeMethod(m_receiver, "processGenerationFinished", Qt::QueuedConnection,
+                              Q_ARG(StyleSheetGenerationResult, result));
+}
+
+QString StyleSheetGenerationTask::generate(const StyleSheetSnapshot& snapshot, StyleSheetPageCache& cache,
+                                           const QAtomicInt* cancel, bool* cancelled)
+{
+    if(cancelled != nullptr)
+        *cancelled = false;
+
+    // update the snippets and variables. the pages that use a changed name are expanded again
+    cache.setDefinitions(snapshot.snippets, snapshot.variables);
+
+    // combine the expanded text from the pages
+    QString text;
+    QSet<QString> ids;
+    for(const StyleSheetPage& page: snapshot.pages)
+    {
+        if(cancel != nullptr && cancel->loadAcquire() != 0)
+        {
+            // the cache stays consistent, the pages expanded so far are kept
+            if(cancelled != nullptr)
+                *cancelled = true;
+            return QString();
+        }
+
+        text += cache.fragment(page.id, page.name, page.qss);
+        ids << page.id;
+    }
+
+    // drop the removed and unchecked pages from the cache
+    cache.retain(ids);
+
+    return text.trimmed();
+}
@@ -0,0 +1,122 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 George Sithole
+** Contact: http://www.geovariant.com/qttitude/
+**
+** This is free software distributed under the terms of the GNU General Public License, GPL v3.
+**
+** "Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are
+** met:
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in
+**     the documentation and/or other materials provided with the
+**     distribution.
+**   * Neither the name of Qttitude nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+**
+****************************************************************************/
+
+#ifndef STYLESHEETGENERATIONTASK_H
+#define STYLESHEETGENERATIONTASK_H
+
+// Qt Libraries
+#include <QRunnable>
+#include <QSharedPointer>
+#include <QAtomicInt>
+#include <QMetaType>
+#include <QList>
+
+// Local Libraries
+#include "stylesheetexpander.h"
+#include "stylesheetpagecache.h"
+
+
+class QObject;
+
+
+/**
+ * @brief The StyleSheetPage struct contains a checked page of the style sheet editor.
+ */
+struct StyleSheetPage
+{
+    QString id;
+    QString name;
+    QString qss;
+};
+
+/**
+ * @brief The StyleSheetSnapshot struct contains a copy of everything needed to generate a style sheet.
+ */
+struct StyleSheetSnapshot
+{
+    StyleSheetDefinitions snippets;
+    StyleSheetDefinitions variables;
+    QList<StyleSheetPage> pages;
+};
+
+/**
+ * @brief The StyleSheetGenerationResult struct is passed from the worker thread back to the editor.
+ */
+struct StyleSheetGenerationResult
+{
+    quint64 revision = 0;
+    bool cancelled = false;
+    QString style_sheet;
+    StyleSheetPageCache cache;
+};
+
+Q_DECLARE_METATYPE(StyleSheetGenerationResult)
+
+
+/**
+ * @brief The StyleSheetGenerationTask class
+ *
+ * Generates a style sheet from a snapshot on a thread pool thread. The task works on its own copy
+ * of the page cache, and hands the style sheet and the updated cache back to the receiver by calling
+ * its processGenerationFinished(StyleSheetGenerationResult) slot through a queued connection. The
+ * task stops between pages once its cancel flag is set.
+ */
+
+class StyleSheetGenerationTask : public QRunnable
+{
+public:
+    StyleSheetGenerationTask(QObject* receiver, const quint64& revision, const StyleSheetSnapshot& snapshot,
+                             const StyleSheetPageCache& cache, QSharedPointer<QAtomicInt> cancel);
+
+    void run() override;
+
+    /** This member function generates the style sheet of a snapshot, and updates the cache. If cancel
+     * is set during the generation the function returns early and sets cancelled.
+     */
+    static QString generate(const StyleSheetSnapshot& snapshot, StyleSheetPageCache& cache,
+                            const QAtomicInt* cancel = nullptr, bool* cancelled = nullptr);
+
+private:
+    QObject* m_receiver;
+
+    quint64 m_revision;
+
+    StyleSheetSnapshot m_snapshot;
+
+    StyleSheetPageCache m_cache;
+
+    QSharedPointer<QAtomicInt> m_cancel;
+};
+
+#endif // STYLESHEETGENERATIONTASK_H
@@ -0,0 +1,133 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 George Sithole
+** Contact: http://www.geovariant.com/qttitude/
+**
+** This is free software distributed under the terms of the GNU General Public License, GPL v3.
+**
+** "Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are
+** met:
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in
+**     the documentation and/or other materials provided with the
+**     distribution.
+**   * Neither the name of Qttitude nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+**
+****************************************************************************/
+
+// Local Libraries
+#include "stylesheetpagecache.h"
+
+
+StyleSheetPageCache::StyleSheetPageCache()
+{
+}
+
+bool StyleSheetPageCache::setDefinitions(const StyleSheetDefinitions& snippets, const StyleSheetDefinitions& variables)
+{
+    if(snippets == m_snippets && variables == m_variables)
+        return false;
+
+    StyleSheetExpander expander(snippets, variables);
+
+    if(expander.isSequential() || m_expander.isSequential())
+    {
+        // the replacements cannot be compared name by name
+        this->invalidate(QSet<QString>::fromList(m_entries.keys()));
+    }
+    else
+    {
+        // a page only sees the final replacement of each of its words, so only the pages that
+        // use a name whose replacement has changed are expanded again
+        QSet<QString> names = QSet<QString>::fromList(m_expander.names()) + QSet<QString>::fromList(expander.names());
+        QSet<QString> changed;
+        for(const QString& name: names)
+        {
+            QString old_value, new_value;
+            bool old_defined = m_expander.resolve(name, &old_value);
+            bool new_defined = expander.resolve(name, &new_value);
+            if(old_defined != new_defined || old_value != new_value)
+                changed << name;
+        }
+        this->invalidate(m_dependencies.pages(changed));
+    }
+
+    m_snippets = snippets;
+    m_variables = variables;
+    m_expander = expander;
+
+    // report snippets and variables that refer to each other or to earlier definitions, they are only partly expanded
+    m_dependencies.setDefinitions(snippets, variables);
+    m_cycles = m_dependencies.cycles();
+    m_back_references = m_dependencies.backReferences();
+
+    return true;
+}
+
+void StyleSheetPageCache::invalidate(const QSet<QString>& ids)
+{
+    for(const QString& id: ids)
+    {
+        m_entries.remove(id);
+        m_dependencies.removePage(id);
+    }
+}
+
+QString StyleSheetPageCache::fragment(const QString& id, const QString& name, const QString& qss)
+{
+    QHash<QString, Entry>::const_iterator iter = m_entries.constFind(id);
+    if(iter != m_entries.constEnd() && iter.value().name == name && iter.value().qss == qss)
+        return iter.value().expanded;
+
+    Entry entry;
+    entry.name = name;
+    entry.qss = qss;
+
+    QSet<QString> words;
+    entry.expanded = m_expander.expand(QString("/* %0 */\n\n%1\n\n").arg(name).arg(qss), &words);
+    m_entries[id] = entry;
+
+    // a sequential expander does not report words, such entries are dropped on every change
+    m_dependencies.setPageWords(id, words);
+
+    return entry.expanded;
+}
+
+void StyleSheetPageCache::retain(const QSet<QString>& ids)
+{
+    QSet<QString> removed;
+    for(const QString& id: m_entries.keys())
+    {
+        if(!ids.contains(id))
+            removed << id;
+    }
+    this->invalidate(removed);
+}
+
+void StyleSheetPageCache::clear()
+{
+    m_entries.clear();
+    m_dependencies.clear();
+    m_cycles.clear();
+    m_back_references.clear();
+    m_snippets.clear();
+    m_variables.clear();
+    m_expander = StyleSheetExpander();
+}
@@ -0,0 +1,125 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 George Sithole
+** Contact: http://www.geovariant.com/qttitude/
+**
+** This is free software distributed under the terms of the GNU General Public License, GPL v3.
+**
+** "Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are
+** met:
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in
+**     the documentation and/or other materials provided with the
+**     distribution.
+**   * Neither the name of Qttitude nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+**
+****************************************************************************/
+
+#ifndef STYLESHEETPAGECACHE_H
+#define STYLESHEETPAGECACHE_H
+
+// Qt Libraries
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QSet>
+
+// Local Libraries
+#include "stylesheetexpander.h"
+#include "stylesheetdependencyindex.h"
+
+
+/**
+ * @brief The StyleSheetPageCache class
+ *
+ * Keeps the expanded style sheet of every page. An entry is reused until the text of its page
+ * changes, or until the replacement of one of the words in the page changes. When the definitions
+ * change, the dependency index gives the pages that use a changed name, and only those entries
+ * are dropped.
+ */
+
+class StyleSheetPageCache
+{
+public:
+    StyleSheetPageCache();
+
+    /** This member function sets the snippets and variables, and invalidates the pages that use a
+     * name whose replacement has changed. The function returns true if the definitions have changed.
+     */
+    bool setDefinitions(const StyleSheetDefinitions& snippets, const StyleSheetDefinitions& variables);
+
+    /** This member function returns the expanded style sheet of a page, including the page banner.
+     */
+    QString fragment(const QString& id, const QString& name, const QString& qss);
+
+    /** This member function removes the pages that are not in ids.
+     */
+    void retain(const QSet<QString>& ids);
+
+    /** This member function removes all the pages and definitions.
+     */
+    void clear();
+
+    /** This member function returns the expander for the current definitions.
+     */
+    const StyleSheetExpander& expander() const {return m_expander;}
+
+    /** This member function returns the dependency index.
+     */
+    const StyleSheetDependencyIndex& dependencies() const {return m_dependencies;}
+
+    /** This member function returns the groups of snippets and variables that refer to each other.
+     */
+    QList<QStringList> cycles() const {return m_cycles;}
+
+    /** This member function returns the snippets and variables that refer to a name defined before them,
+     * with the name.
+     */
+    QList<QPair<QString, QString>> backReferences() const {return m_back_references;}
+
+protected:
+    void invalidate(const QSet<QString>& ids);
+
+private:
+    struct Entry
+    {
+        QString name;
+        QString qss;
+        QString expanded;
+    };
+
+    /** This member variable contains the cached pages. The key is the page id.
+     */
+    QHash<QString, Entry> m_entries;
+
+    StyleSheetDependencyIndex m_dependencies;
+
+    QList<QStringList> m_cycles;
+
+    QList<QPair<QString, QString>> m_back_references;
+
+    StyleSheetDefinitions m_snippets;
+
+    StyleSheetDefinitions m_variables;
+
+    StyleSheetExpander m_expander;
+};
+
+#endif // STYLESHEETPAGECACHE_H
@@ -0,0 +1,522 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 George Sithole
+** Contact: http://www.geovariant.com/qttitude/
+**
+** This is free software distributed under the terms of the GNU General Public License, GPL v3.
+**
+** "Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are
+** met:
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in
+**     the documentation and/or other materials provided with the
+**     distribution.
+**   * Neither the name of Qttitude nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+**
+****************************************************************************/
+
+// C/C++ Libraries
+#include <cstring>
+#include <algorithm>
+#include <vector>
+
+// Qt Libraries
+#include <QDataStream>
+#include <QDateTime>
+#include <QDebug>
+#include <QLocalServer>
+#include <QLocalSocket>
+
+// Local Libraries
+#include "stylesheetserver.h"
+#include "stylesheetprotocol.h"
+
+
+StyleSheetServer::StyleSheetServer(QObject *parent) :
+    QObject(parent),
+    m_generation(0),
+    m_sequence(0),
+    m_pending_edit_time(0),
+    m_publishing(false)
+{
+    m_control.setKey("StyleSheetSharedMemory");
+
+    m_retry_timer.setSingleShot(true);
+    m_retry_timer.setInterval(100);
+    connect(&m_retry_timer, SIGNAL(timeout()), this, SLOT(processRetry()));
+
+    m_local_server = new QLocalServer(this);
+    connect(m_local_server, SIGNAL(newConnection()), this, SLOT(processNewConnection()));
+
+    // a server name that another editor is listening on is kept, and nothing is published, so the clients stay with
+    // that editor. the server name is probed on the next event loop turn, after the owner has connected the signals
+    m_probe = new QLocalSocket(this);
+    connect(m_probe, SIGNAL(connected()), this, SLOT(processProbeConnected()));
+    connect(m_probe, SIGNAL(error(QLocalSocket::LocalSocketError)), this, SLOT(processProbeError()));
+    QTimer::singleShot(0, this, SLOT(probeServerName()));
+}
+
+StyleSheetServer::~StyleSheetServer()
+{
+    if(m_memory.isAttached()) m_memory.detach();
+    if(m_control.isAttached()) m_control.detach();
+}
+
+bool StyleSheetServer::publishStyleSheet(const QString& style_sheet, const qint64& edit_time)
+{
+    // the style sheet is published once the server name is known to be free, and never if it belongs to another editor
+    if(!m_publishing)
+    {
+        if(m_probe)
+        {
+            m_pending_style_sheet = style_sheet;
+            m_pending_edit_time = edit_time > 0 ? edit_time : QDateTime::currentMSecsSinceEpoch();
+        }
+        return false;
+    }
+
+    QByteArray bytes = style_sheet.toUtf8();
+    int size = bytes.size();
+
+    quint32 generation = m_generation;
+    if(!this->reserve(size))
+    {
+        m_pending_style_sheet = style_sheet;
+        m_pending_edit_time = edit_time > 0 ? edit_time : QDateTime::currentMSecsSinceEpoch();
+        m_retry_timer.start();
+        return false;
+    }
+    m_pending_style_sheet.clear();
+    m_retry_timer.stop();
+
+    // write into the slot after the published one. the slot is cleared first, so a client reading it meanwhile
+    // knows that it has to read the slot again
+    StyleSheetSegmentHeader* header = (StyleSheetSegmentHeader*)m_memory.data();
+    quint32 index = (header->published.loadAcquire() + 1) % StyleSheetSegmentHeader::SlotCount;
+    StyleSheetSlot* slot = header->slot(index);
+    slot->sequence.fetchAndStoreOrdered(0);
+    memcpy((char*)(slot + 1), bytes.constData(), size);
+    slot->size = quint32(size);
+    slot->checksum = qChecksum(bytes.constData(), uint(size));
+    slot->edit_time = edit_time > 0 ? edit_time : QDateTime::currentMSecsSinceEpoch();
+    this->writeChange(slot, style_sheet, bytes);
+
+    // publish the slot
+    if(++m_sequence == 0) ++m_sequence;
+    slot->sequence.storeRelease(m_sequence);
+    header->published.storeRelease(index);
+    header->sequence.storeRelease(m_sequence);
+    m_style_sheet = style_sheet;
+
+    // move the clients to a new segment once it holds the style sheet
+    if(m_generation != generation)
+    {
+        StyleSheetControlHeader* control = (StyleSheetControlHeader*)m_control.data();
+        control->generation.storeRelease(m_generation);
+    }
+
+    this->notifyClients();
+    return true;
+}
+
+void StyleSheetServer::writeChange(StyleSheetSlot* slot, const QString& style_sheet, const QByteArray& bytes)
+{
+    slot->base_sequence = 0;
+    if(m_sequence == 0)
+        return;
+
+    // find the text the style sheets start and end with
+    const QString& old_sheet = m_style_sheet;
+    int min_size = qMin(old_sheet.size(), style_sheet.size());
+    int prefix = 0;
+    while(prefix < min_size && old_sheet.at(prefix) == style_sheet.at(prefix))
+        ++prefix;
+    int suffix = 0;
+    while(suffix < min_size - prefix &&
+          old_sheet.at(old_sheet.size() - 1 - suffix) == style_sheet.at(style_sheet.size() - 1 - suffix))
+        ++suffix;
+
+    // widen the change to whole rule blocks, which end with '}'
+    prefix = prefix > 0 ? style_sheet.lastIndexOf('}', prefix - 1) + 1 : 0;
+    int end = style_sheet.size() - suffix;
+    if(end > 0 && style_sheet.at(end - 1) != '}')
+    {
+        int close = style_sheet.indexOf('}', end);
+        end = close < 0 ? style_sheet.size() : close + 1;
+    }
+    end = qMax(end, prefix);
+    suffix = style_sheet.size() - end;
+
+    // the byte offset of the new blocks. a block boundary never splits a surrogate pair
+    quint32 byte_offset = 0;
+    for(int i = 0; i < prefix; ++i)
+    {
+        ushort c = style_sheet.at(i).unicode();
+        byte_offset += c < 0x80 ? 1 : (c < 0x800 || QChar::isSurrogate(c)) ? 2 : 3;
+    }
+    quint32 byte_inserted = quint32(bytes.size()) - byte_offset;
+    for(int i = end; i < style_sheet.size(); ++i)
+    {
+        ushort c = style_sheet.at(i).unicode();
+        byte_inserted -= c < 0x80 ? 1 : (c < 0x800 || QChar::isSurrogate(c)) ? 2 : 3;
+    }
+
+    slot->char_offset = quint32(prefix);
+    slot->char_removed = quint32(old_sheet.size() - prefix - suffix);
+    slot->byte_offset = byte_offset;
+    slot->byte_inserted = byte_inserted;
+    slot->delta_checksum = qChecksum(bytes.constData() + byte_offset, byte_inserted);
+    slot->base_sequence = m_sequence;
+}
+
+void StyleSheetServer::probeServerName()
+{
+    m_probe->connectToServer("StyleSheetServer");
+}
+
+void StyleSheetServer::processProbeConnected()
+{
+    m_probe->disconnect(this);
+    m_probe->abort();
+    m_probe->deleteLater();
+    m_probe = nullptr;
+    m_pending_style_sheet.clear();
+
+    m_error_string = tr("Another Qttitude is publishing style sheets to the running applications");
+    qDebug() << "Error: StyleSheetServer. " << m_error_string;
+    emit this->serverError(m_error_string);
+}
+
+void StyleSheetServer::processProbeError()
+{
+    m_probe->disconnect(this);
+    m_probe->deleteLater();
+    m_probe = nullptr;
+
+    // listen for clients. a server name left by a crashed server is removed first
+    QLocalServer::removeServer("StyleSheetServer");
+    if(!m_local_server->listen("StyleSheetServer"))
+    {
+        m_error_string = m_local_server->errorString();
+        qDebug() << "Error: StyleSheetServer. Failed to listen " << m_error_string;
+        emit this->serverError(m_error_string);
+    }
+
+    // publish the style sheet requested meanwhile
+    m_publishing = true;
+    this->processRetry();
+}
+
+void StyleSheetServer::processRetry()
+{
+    if(!m_pending_style_sheet.isNull())
+        this->publishStyleSheet(m_pending_style_sheet, m_pending_edit_time);
+}
+
+void StyleSheetServer::processNewConnection()
+{
+    while(m_local_server->hasPendingConnections())
+    {
+        QLocalSocket* socket = m_local_server->nextPendingConnection();
+        connect(socket, SIGNAL(disconnected()), this, SLOT(processDisconnected()));
+        connect(socket, SIGNAL(readyRead()), this, SLOT(processClientMessage()));
+        m_clients.insert(socket, StyleSheetClientInfo());
+    }
+    emit this->clientsChanged();
+}
+
+void StyleSheetServer::processDisconnected()
+{
+    QLocalSocket* socket = qobject_cast<QLocalSocket*>(this->sender());
+    m_clients.remove(socket);
+    if(socket)
+        socket->deleteLater();
+    emit this->clientsChanged();
+}
+
+void StyleSheetServer::processClientMessage()
+{
+    QLocalSocket* socket = qobject_cast<QLocalSocket*>(this->sender());
+    if(!socket || !m_clients.contains(socket))
+        return;
+
+    // read the complete messages. an incomplete message is read when the rest arrives
+    StyleSheetClientInfo& info = m_clients[socket];
+    QDataStream in(socket);
+    in.setVersion(QDataStream::Qt_5_0);
+    while(!socket->atEnd())
+    {
+        in.startTransaction();
+
+        quint8 type = 0;
+        in >> type;
+        if(type == RegisterMessage) {
+            quint32 version = 0;
+            qint64 pid = 0;
+            QString name;
+            in >> version >> pid >> name;
+            if(in.commitTransaction()) {
+                // a client of another protocol version misreads the segments and the messages
+                if(version != StyleSheetProtocolVersion) {
+                    socket->abort();
+                    return;
+                }
+                info.pid = pid;
+                info.name = name;
+                continue;
+            }
+        } else if(type == AcknowledgeMessage) {
+            quint32 sequence = 0, duration = 0;
+            in >> sequence >> duration;
+            if(in.commitTransaction()) {
+                info.sequence = sequence;
+                info.apply_duration = duration;
+                continue;
+            }
+        } else if(type == LatencyMessage) {
+            quint32 sequence = 0, duration = 0;
+            qint64 edit_time = 0, receive_time = 0, paint_time = 0;
+            in >> sequence >> edit_time >> receive_time >> duration >> paint_time;
+            if(in.commitTransaction()) {
+                this->addLatency(edit_time, receive_time, duration, paint_time);
+                continue;
+            }
+        } else if(type == ObjectTreeMessage) {
+            QByteArray tree;
+            in >> tree;
+            if(in.commitTransaction()) {
+                StyleSheetServer::readObjectTree(info, tree);
+                continue;
+            }
+        } else if(type == AddObjectMessage) {
+            quint64 id = 0;
+            StyleSheetAppObject object;
+            in >> id >> object.parent >> object.name >> object.class_name;
+            if(in.commitTransaction()) {
+                StyleSheetServer::removeObject(info, id);
+                info.objects.insert(id, object);
+                info.children.insert(object.parent, id);
+                continue;
+            }
+        } else if(type == RemoveObjectMessage) {
+            quint64 id = 0;
+            in >> id;
+            if(in.commitTransaction()) {
+                StyleSheetServer::removeObject(info, id);
+                continue;
+            }
+        } else {
+            // the client does not speak this protocol
+            in.abortTransaction();
+            socket->readAll();
+        }
+        break;
+    }
+
+    emit this->clientsChanged();
+}
+
+void StyleSheetServer::addLatency(const qint64& edit_time, const qint64& receive_time, const quint32& duration,
+                                  const qint64& paint_time)
+{
+    // ignore the times of a client whose clock stepped. the paint time is 0 if the style sheet caused no paint
+    if(edit_time <= 0 || receive_time < edit_time || (paint_time != 0 && paint_time < receive_time))
+        return;
+
+    StyleSheetLatency latency;
+    latency.receive = double(receive_time - edit_time);
+    latency.apply = duration / 1000.0;
+    latency.paint = paint_time != 0 ? double(paint_time - edit_time) : -1;
+
+    m_latencies << latency;
+    while(m_latencies.count() > LatencyWindow)
+        m_latencies.removeFirst();
+    emit this->latenciesChanged();
+}
+
+StyleSheetLatency StyleSheetServer::latencyPercentile(const double& p) const
+{
+    StyleSheetLatency percentile;
+    if(m_latencies.isEmpty())
+        return percentile;
+
+    // the nearest rank of each latency
+    std::vector<double> receive, apply, paint;
+    receive.reserve(size_t(m_latencies.count()));
+    apply.reserve(size_t(m_latencies.count()));
+    paint.reserve(size_t(m_latencies.count()));
+    for(const StyleSheetLatency& latency: m_latencies)
+    {
+        receive.push_back(latency.receive);
+        apply.push_back(latency.apply);
+        if(latency.paint >= 0)
+            paint.push_back(latency.paint);
+    }
+
+    size_t rank = size_t(qBound(0.0, p, 1.0) * (m_latencies.count() - 1) + 0.5);
+    std::nth_element(receive.begin(), receive.begin() + rank, receive.end());
+    std::nth_element(apply.begin(), apply.begin() + rank, apply.end());
+    percentile.receive = receive[rank];
+    percentile.apply = apply[rank];
+
+    // the style sheets that caused no paint have no paint latency
+    if(!paint.empty())
+    {
+        size_t paint_rank = size_t(qBound(0.0, p, 1.0) * (paint.size() - 1) + 0.5);
+        std::nth_element(paint.begin(), paint.begin() + paint_rank, paint.end());
+        percentile.paint = paint[paint_rank];
+    }
+    return percentile;
+}
+
+void StyleSheetServer::readObjectTree(StyleSheetClientInfo& info, const QByteArray& tree)
+{
+    info.objects.clear();
+    info.children.clear();
+
+    QDataStream in(tree);
+    in.setVersion(QDataStream::Qt_5_0);
+    StyleSheetObjectTreeReader reader(in);
+
+    // the nodes refer to their parents by node index
+    QVector<quint64> ids;
+    StyleSheetObjectTreeNode node;
+    while(reader.readNode(node))
+    {
+        StyleSheetAppObject object;
+        object.parent = node.parent < 0 ? 0 : ids.at(node.parent);
+        object.name = node.name;
+        object.class_name = node.class_name;
+        info.objects.insert(node.id, object);
+        info.children.insert(object.parent, node.id);
+        ids << node.id;
+    }
+
+    if(!reader.isValid())
+        qDebug() << "Error: StyleSheetServer. Invalid object tree from client " << info.pid;
+}
+
+void StyleSheetServer::removeObject(StyleSheetClientInfo& info, const quint64& id)
+{
+    if(!info.objects.contains(id))
+        return;
+
+    for(const quint64& child: info.children.values(id))
+        StyleSheetServer::removeObject(info, child);
+
+    info.children.remove(info.objects.value(id).parent, id);
+    info.children.remove(id);
+    info.objects.remove(id);
+}
+
+void StyleSheetServer::notifyClients()
+{
+    // the notification is the sequence number. the clients read the style sheet from the shared memory
+    QByteArray notification;
+    QDataStream out(&notification, QIODevice::WriteOnly);
+    out << m_sequence;
+
+    for(QLocalSocket* socket: m_clients.keys())
+    {
+        socket->write(notification);
+        socket->flush();
+    }
+
+    // the clients are behind until they acknowledge the style sheet
+    if(!m_clients.isEmpty())
+        emit this->clientsChanged();
+}
+
+bool StyleSheetServer::attachControl()
+{
+    if(m_control.isAttached())
+        return true;
+
+    if(m_control.create(int(sizeof(StyleSheetControlHeader))))
+    {
+        StyleSheetControlHeader* control = (StyleSheetControlHeader*)m_control.data();
+        control->version = StyleSheetProtocolVersion;
+        control->generation.storeRelease(0);
+        return true;
+    }
+
+    // continue the generations of an earlier server
+    if(m_control.error() == QSharedMemory::AlreadyExists && m_control.attach())
+    {
+        if(m_control.size() < int(sizeof(StyleSheetControlHeader)))
+        {
+            m_control.detach();
+            qDebug() << "Error: StyleSheetServer. The shared memory of an earlier server has a different layout";
+            return false;
+        }
+
+        StyleSheetControlHeader* control = (StyleSheetControlHeader*)m_control.data();
+        control->version = StyleSheetProtocolVersion;
+        m_generation = qMax(m_generation, control->generation.loadAcquire());
+        return true;
+    }
+
+    qDebug() << "Error: StyleSheetServer. Failed to create shared memory " << m_control.errorString();
+    return false;
+}
+
+bool StyleSheetServer::reserve(const int& size)
+{
+    if(m_memory.isAttached())
+    {
+        StyleSheetSegmentHeader* header = (StyleSheetSegmentHeader*)m_memory.data();
+        if(header->capacity >= quint32(size))
+            return true;
+    }
+
+    if(!this->attachControl())
+        return false;
+
+    // the clients stay attached to the current segment until the new segment is published
+    if(m_memory.isAttached())
+        m_memory.detach();
+
+    // leave room for the style sheet to grow. the slots are 8 byte aligned
+    quint32 capacity = quint32(qMax(2 * size, 64 * 1024) + 7) & ~quint32(7);
+
+    // create the segment of the next generation. the keys of segments left by a crashed server are skipped
+    for(int attempt = 0; attempt < 16; ++attempt)
+    {
+        quint32 generation = m_generation + 1;
+        if(generation == 0) generation = 1;
+        m_generation = generation;
+
+        m_memory.setKey(StyleSheetSegmentHeader::key(generation));
+        if(m_memory.create(StyleSheetSegmentHeader::segmentSize(capacity)))
+        {
+            memset(m_memory.data(), 0, size_t(m_memory.size()));
+            StyleSheetSegmentHeader* header = (StyleSheetSegmentHeader*)m_memory.data();
+            header->capacity = capacity;
+            header->published.storeRelease(StyleSheetSegmentHeader::SlotCount - 1);
+            return true;
+        }
+
+        if(m_memory.error() != QSharedMemory::AlreadyExists)
+            break;
+    }
+
+    qDebug() << "Error: StyleSheetServer. Failed to create shared memory " << m_memory.errorString();
+    return false;
+}
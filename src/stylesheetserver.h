@@ -0,0 +1,227 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 George Sithole
+** Contact: http://www.geovariant.com/qttitude/
+**
+** This is free software distributed under the terms of the GNU General Public License, GPL v3.
+**
+** "Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are
+** met:
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in
+**     the documentation and/or other materials provided with the
+**     distribution.
+**   * Neither the name of Qttitude nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+**
+****************************************************************************/
+
+#ifndef STYLESHEETSERVER_H
+#define STYLESHEETSERVER_H
+
+// Qt Libraries
+#include <QObject>
+#include <QSharedMemory>
+#include <QTimer>
+#include <QList>
+#include <QHash>
+#include <QMultiHash>
+#include <QString>
+
+
+class QLocalServer;
+class QLocalSocket;
+struct StyleSheetSlot;
+
+
+/**
+ * @brief The StyleSheetAppObject struct contains an object of a running application.
+ */
+struct StyleSheetAppObject
+{
+    quint64 parent = 0; // the id of the parent, and 0 for the root object
+    QString name;
+    QString class_name;
+};
+
+/**
+ * @brief The StyleSheetLatency struct contains the latencies of a style sheet applied by a client, in milliseconds.
+ */
+struct StyleSheetLatency
+{
+    double receive = 0; // from the edit until the client read the style sheet
+    double apply = 0; // the time the client took to apply the style sheet
+    double paint = 0; // from the edit until the first paint after the style sheet was applied, and -1 without a paint
+};
+
+/**
+ * @brief The StyleSheetClientInfo struct contains a registered client, the sequence number of the last style sheet
+ * it has applied, and a mirror of its object tree that the client keeps up to date.
+ */
+struct StyleSheetClientInfo
+{
+    qint64 pid = 0;
+    QString name;
+    quint32 sequence = 0; // the sequence number of the last style sheet applied
+    quint32 apply_duration = 0; // the time it took to apply the style sheet, in microseconds
+    QHash<quint64, StyleSheetAppObject> objects; // the objects by their ids
+    QMultiHash<quint64, quint64> children; // the ids of the children by the ids of their parents
+};
+
+
+/**
+ * @brief The StyleSheetServer class publishes the style sheet to the applications running a StyleSheetClient.
+ *
+ * The style sheet is written to a free slot of a shared memory segment, and the slot is then published with a new
+ * sequence number, so the clients read the style sheet without a lock. A style sheet larger than the slots is written
+ * to a segment of a new generation, and the generation is published in the "StyleSheetSharedMemory" segment. The
+ * clients then move to the new segment. See StyleSheetSegmentHeader.
+ *
+ * The clients connected to the local server "StyleSheetServer" are notified of each publication, so that they read
+ * the style sheet without polling. Each client registers, and acknowledges the style sheets it applies.
+ *
+ * Every slot holds the whole style sheet, and the change from the previous style sheet. A client that read the previous
+ * style sheet reads only the changed rule blocks, and tests the result against the checksum of the whole style sheet.
+ * Other clients, e.g. clients that missed a publication, read the whole style sheet, and so does every client from time
+ * to time. The whole style sheet is still written to every slot for them.
+ */
+class StyleSheetServer : public QObject
+{
+    Q_OBJECT
+public:
+    explicit StyleSheetServer(QObject *parent = nullptr);
+    ~StyleSheetServer();
+
+    /** This member function returns the sequence number of the last published style sheet.
+     */
+    quint32 sequence() const {return m_sequence;}
+
+    /** This member function returns the reason the clients cannot connect to the server, e.g. because another editor
+     * is listening. It is empty if the server is listening.
+     */
+    QString errorString() const {return m_error_string;}
+
+    /** This member function returns the connected clients.
+     */
+    QList<StyleSheetClientInfo> clients() const {return m_clients.values();}
+
+    /** This member function returns the number of latencies the percentiles are computed from. The latencies of the
+     * last LatencyWindow style sheets applied by the clients are kept.
+     */
+    int latencyCount() const {return m_latencies.count();}
+
+    /** This member function returns the p-th percentile, with p in [0, 1], of each of the recent latencies.
+     */
+    StyleSheetLatency latencyPercentile(const double& p) const;
+
+    static const int LatencyWindow = 200;
+
+signals:
+    void clientsChanged();
+
+    void latenciesChanged();
+
+    /** This signal is emitted if the clients cannot connect to the server, e.g. because another editor is listening.
+     */
+    void serverError(const QString& message);
+
+public slots:
+    /** This member function publishes a style sheet generated for an edit at edit_time, in milliseconds since the
+     * epoch. The edit time is the current time if it is 0. It returns false if the publication is retried later, e.g.
+     * while the server name is probed, or if another editor publishes the style sheets.
+     */
+    bool publishStyleSheet(const QString& style_sheet, const qint64& edit_time = 0);
+
+private slots:
+    void probeServerName();
+
+    void processProbeConnected();
+
+    void processProbeError();
+
+    void processRetry();
+
+    void processNewConnection();
+
+    void processDisconnected();
+
+    void processClientMessage();
+
+protected:
+    bool attachControl();
+
+    bool reserve(const int& size);
+
+    void notifyClients();
+
+    /** This member function adds the latencies reported by a client. The times are in milliseconds since the epoch,
+     * and the duration is in microseconds.
+     */
+    void addLatency(const qint64& edit_time, const qint64& receive_time, const quint32& duration, const qint64& paint_time);
+
+    static void readObjectTree(StyleSheetClientInfo& info, const QByteArray& tree);
+
+    static void removeObject(StyleSheetClientInfo& info, const quint64& id);
+
+    /** This member function writes the change from the last published style sheet to the slot.
+     */
+    void writeChange(StyleSheetSlot* slot, const QString& style_sheet, const QByteArray& bytes);
+
+private:
+    /** This member variable contains the generation of the style sheet segment.
+     */
+    QSharedMemory m_control;
+
+    QSharedMemory m_memory;
+
+    quint32 m_generation;
+
+    quint32 m_sequence;
+
+    /** This member variable contains the last published style sheet.
+     */
+    QString m_style_sheet;
+
+    QString m_pending_style_sheet;
+
+    qint64 m_pending_edit_time;
+
+    QTimer m_retry_timer;
+
+    QLocalServer* m_local_server;
+
+    /** This member variable connects to the server name before the server listens, and is null once it has
+     */
+    QLocalSocket* m_probe;
+
+    QString m_error_string;
+
+    /** This member variable is false until the server name is known to be free. If another editor is listening on
+     * it, the shared memory is left to that editor.
+     */
+    bool m_publishing;
+
+    QHash<QLocalSocket*, StyleSheetClientInfo> m_clients;
+
+    /** This member variable contains the latencies of the last style sheets applied by the clients, oldest first.
+     */
+    QList<StyleSheetLatency> m_latencies;
+};
+
+#endif // STYLESHEETSERVER_H
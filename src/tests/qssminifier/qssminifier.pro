@@ -0,0 +1,24 @@
+#-------------------------------------------------
+#
+# The unit tests of the style sheet minifier.
+#
+#-------------------------------------------------
+
+QT += core testlib
+QT -= gui
+CONFIG += c++14 console testcase
+CONFIG -= app_bundle
+
+TARGET = tst_qssminifier
+TEMPLATE = app
+
+INCLUDEPATH += ../..
+
+SOURCES += \
+    tst_qssminifier.cpp \
+    ../../qssparser.cpp \
+    ../../qssminifier.cpp
+
+HEADERS += \
+    ../../qssparser.h \
+    ../../qssminifier.h
@@ -0,0 +1,86 @@
+/****************************************************************************
+**
+** Copyright (C) 2019 George Sithole
+** Contact: http://www.geovariant.com/qttitude/
+**
+** This is free software distributed under the terms of the GNU General Public License, GPL v3.
+**
+** "Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are
+** met:
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in
+**     the documentation and/or other materials provided with the
+**     distribution.
+**   * Neither the name of Qttitude nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE."
+**
+****************************************************************************/
+
+// Qt Libraries
+#include <QtTest>
+
+// Local Libraries
+#include "qssminifier.h"
+
+
+class TestQssMinifier : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void minify_data();
+    void minify();
+};
+
+void TestQssMinifier::minify_data()
+{
+    QTest::addColumn<QString>("style_sheet");
+    QTest::addColumn<QString>("minified");
+
+    QTest::newRow("overridden declaration")
+            << "QLabel { color: red; color: blue; }"
+            << "QLabel{color:blue}";
+    QTest::newRow("important declaration")
+            << "QLabel { color: red !important; color: blue; }"
+            << "QLabel{color:red !important}";
+    QTest::newRow("later important declaration")
+            << "QLabel { color: red !important; color: blue ! important; }"
+            << "QLabel{color:blue ! important}";
+    QTest::newRow("merged rules")
+            << "QLabel { color: red !important; } QLabel { color: blue; margin: 2px; }"
+            << "QLabel{color:red !important;margin:2px}";
+    QTest::newRow("conflicting rules")
+            << "QLabel { color: red; } QFrame { color: green; } QLabel { color: blue; }"
+            << "QFrame{color:green}QLabel{color:blue}";
+    QTest::newRow("conflicting rules with an important declaration")
+            << "QLabel { color: red !important; } QFrame { color: green; } QLabel { color: blue; }"
+            << "QLabel{color:red !important}QFrame{color:green}QLabel{color:blue}";
+}
+
+void TestQssMinifier::minify()
+{
+    QFETCH(QString, style_sheet);
+    QFETCH(QString, minified);
+
+    QCOMPARE(QssMinifier::minify(style_sheet), minified);
+}
+
+QTEST_APPLESS_MAIN(TestQssMinifier)
+
+#include "tst_qssminifier.moc"
@@ -0,0 +1,262 @@
+#pragma once
+
+// only included in case there's a C++11 compiler out there that doesn't support `#pragma once`
+#ifndef DKM_HAMERLY_KMEANS_H
+#define DKM_HAMERLY_KMEANS_H
+
+#include "dkm_parallel.hpp"
+
+#include <cmath>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define DKM_HAMERLY_SSE2
+#endif
+
+/*
+DKM - A k-means implementation that is generic across variable data dimensions.
+
+This file contains a variant of kmeans_lloyd_parallel that skips most of the distance calculations
+once the clusters settle, using the bounds of [Hamerly's algorithm](https://doi.org/10.1137/1.9781611972801.12).
+*/
+namespace dkm {
+
+namespace details {
+
+/*
+The bounds of a point: the distance to its mean is at most upper, and the distance to any other mean
+is at least lower.
+*/
+template <typename T>
+struct hamerly_bounds {
+	T upper;
+	T lower;
+};
+
+/*
+The coordinates of the means in separate planes, so the distances from a point to several means are
+calculated at once. The planes are padded to a multiple of 4 means that are further from any point
+than the other means.
+*/
+template <typename T, size_t N>
+struct mean_planes {
+	size_t size = 0;
+	std::vector<T> planes;
+
+	void assign(const std::vector<std::array<T, N>>& means) {
+		size = (means.size() + 3) / 4 * 4;
+		planes.assign(N * size, std::sqrt(std::numeric_limits<T>::max()) / 4);
+		for (size_t i = 0; i < means.size(); ++i) {
+			for (size_t j = 0; j < N; ++j) {
+				planes[j * size + i] = means[i][j];
+			}
+		}
+	}
+
+	const T* plane(size_t j) const { return &planes[j * size]; }
+};
+
+/*
+Find the closest and the second closest mean of a point. The closest mean is the one closest_mean
+picks, and the bounds are the exact distances to the two means.
+*/
+template <typename T, size_t N>
+uint32_t closest_means_bounded(
+	const std::array<T, N>& point, const mean_planes<T, N>& means, uint32_t k, hamerly_bounds<T>& bounds) {
+	T smallest = std::numeric_limits<T>::max();
+	T second = std::numeric_limits<T>::max();
+	uint32_t index = 0;
+	for (uint32_t i = 0; i < k; ++i) {
+		T distance = T();
+		for (size_t j = 0; j < N; ++j) {
+			T delta = point[j] - means.plane(j)[i];
+			distance += delta * delta;
+		}
+		if (i == 0 || distance < smallest) {
+			second = smallest;
+			smallest = distance;
+			index = i;
+		} else if (distance < second) {
+			second = distance;
+		}
+	}
+	bounds.upper = std::sqrt(smallest);
+	bounds.lower = std::sqrt(second);
+	return index;
+}
+
+#ifdef DKM_HAMERLY_SSE2
+/*
+As above for float points, with the distances to 4 means calculated at once. Each lane keeps the
+closest and second closest of its means, and the lanes are then merged.
+*/
+template <size_t N>
+uint32_t closest_means_bounded(
+	const std::array<float, N>& point, const mean_planes<float, N>& means, uint32_t, hamerly_bounds<float>& bounds) {
+	__m128 best = _mm_set1_ps(std::numeric_limits<float>::max());
+	__m128 second = best;
+	__m128i best_index = _mm_setzero_si128();
+	__m128i index = _mm_set_epi32(3, 2, 1, 0);
+	const __m128i step = _mm_set1_epi32(4);
+	for (size_t i = 0; i < means.size; i += 4) {
+		__m128 distance = _mm_setzero_ps();
+		for (size_t j = 0; j < N; ++j) {
+			__m128 delta = _mm_sub_ps(_mm_set1_ps(point[j]), _mm_loadu_ps(means.plane(j) + i));
+			distance = _mm_add_ps(distance, _mm_mul_ps(delta, delta));
+		}
+		__m128 closer = _mm_cmplt_ps(distance, best);
+		second = _mm_or_ps(_mm_and_ps(closer, best), _mm_andnot_ps(closer, _mm_min_ps(distance, second)));
+		best = _mm_min_ps(distance, best);
+		__m128i closer_index = _mm_castps_si128(closer);
+		best_index = _mm_or_si128(_mm_and_si128(closer_index, index), _mm_andnot_si128(closer_index, best_index));
+		index = _mm_add_epi32(index, step);
+	}
+
+	// the closest of the lanes, and the first of equally close means
+	float lane_best[4], lane_second[4];
+	uint32_t lane_index[4];
+	_mm_storeu_ps(lane_best, best);
+	_mm_storeu_ps(lane_second, second);
+	_mm_storeu_si128((__m128i*)lane_index, best_index);
+	size_t lane = 0;
+	for (size_t l = 1; l < 4; ++l) {
+		if (lane_best[l] < lane_best[lane] || (lane_best[l] == lane_best[lane] && lane_index[l] < lane_index[lane]))
+			lane = l;
+	}
+	float second_distance = lane_second[lane];
+	for (size_t l = 0; l < 4; ++l) {
+		if (l != lane)
+			second_distance = std::min(second_distance, lane_best[l]);
+	}
+	bounds.upper = std::sqrt(lane_best[lane]);
+	bounds.lower = std::sqrt(second_distance);
+	return lane_index[lane];
+}
+#endif
+
+} // namespace details
+
+/*
+A variant of kmeans_lloyd_parallel with Hamerly's bounds. A point whose distance to its mean is at
+most the distance to any other mean, or half the distance from its mean to the closest other mean,
+keeps its mean without calculating the distances to the other means. The bounds are loosened by the
+distances the means move in each iteration.
+
+The iterations stop when no mean moves further than the tolerance, or after max_iterations
+iterations if it is not 0. With a tolerance of 0 the iterations stop when the means no longer change,
+as in kmeans_lloyd. The clusters are the same as those of kmeans_lloyd_parallel for the same seed,
+except for points whose distances to two means differ by no more than the rounding of the bounds.
+*/
+template <typename T, size_t N>
+std::tuple<std::vector<std::array<T, N>>, std::vector<uint32_t>> kmeans_hamerly(
+	const std::vector<std::array<T, N>>& data, uint32_t k, uint64_t seed, T tolerance = T(),
+	uint32_t max_iterations = 0, size_t threads = 0) {
+	static_assert(std::is_floating_point<T>::value,
+		"kmeans_hamerly requires the template parameter T to be a floating point type (e.g. float, double)");
+	assert(k > 0); // k must be greater than zero
+	assert(data.size() >= k); // there must be at least k data points
+
+	const size_t blocks = (data.size() + details::parallel_block_size - 1) / details::parallel_block_size;
+	if (threads == 0)
+		threads = std::max(1u, std::thread::hardware_concurrency());
+	details::thread_pool pool(std::min(threads, blocks));
+
+	std::vector<std::array<T, N>> means = details::random_plusplus_parallel(data, k, seed, pool);
+
+	std::vector<std::array<T, N>> old_means;
+	std::vector<uint32_t> clusters(data.size());
+	std::vector<details::hamerly_bounds<T>> bounds(data.size());
+	details::mean_planes<T, N> planes;
+	std::vector<T> half_spacing(k); // half the distance from each mean to the closest other mean
+	std::vector<T> moved(k, T()); // the distance each mean moved in the last iteration
+	std::vector<std::array<T, N>> sums(blocks * k);
+	std::vector<T> counts(blocks * k);
+	for (uint32_t iteration = 0; max_iterations == 0 || iteration < max_iterations; ++iteration) {
+		// the furthest and the second furthest distances the means moved
+		uint32_t furthest = 0;
+		T furthest_moved = T(), second_moved = T();
+		for (uint32_t c = 0; c < k; ++c) {
+			if (moved[c] > furthest_moved) {
+				second_moved = furthest_moved;
+				furthest_moved = moved[c];
+				furthest = c;
+			} else if (moved[c] > second_moved) {
+				second_moved = moved[c];
+			}
+		}
+
+		for (uint32_t c = 0; c < k; ++c) {
+			T closest = std::numeric_limits<T>::max();
+			for (uint32_t other = 0; other < k; ++other) {
+				if (other != c)
+					closest = std::min(closest, details::distance_squared(means[c], means[other]));
+			}
+			half_spacing[c] = std::sqrt(closest) / 2;
+		}
+		planes.assign(means);
+
+		// Assign the points to their closest means, and sum the points of each cluster per block
+		pool.run(blocks, [&](size_t block) {
+			std::array<T, N>* block_sums = &sums[block * k];
+			T* block_counts = &counts[block * k];
+			std::fill(block_sums, block_sums + k, std::array<T, N>());
+			std::fill(block_counts, block_counts + k, T());
+			size_t end = std::min(data.size(), (block + 1) * details::parallel_block_size);
+			for (size_t i = block * details::parallel_block_size; i < end; ++i) {
+				uint32_t& cluster = clusters[i];
+				details::hamerly_bounds<T>& bound = bounds[i];
+				if (iteration == 0) {
+					cluster = details::closest_means_bounded(data[i], planes, k, bound);
+				} else {
+					// loosen the bounds by the distances the means moved
+					bound.upper += moved[cluster];
+					bound.lower -= cluster == furthest ? second_moved : furthest_moved;
+
+					T limit = std::max(half_spacing[cluster], bound.lower);
+					if (bound.upper > limit) {
+						// tighten the upper bound, and search the other means only if it is still too loose
+						bound.upper = std::sqrt(details::distance_squared(data[i], means[cluster]));
+						if (bound.upper > limit)
+							cluster = details::closest_means_bounded(data[i], planes, k, bound);
+					}
+				}
+
+				block_counts[cluster] += 1;
+				for (size_t j = 0; j < N; ++j) {
+					block_sums[cluster][j] += data[i][j];
+				}
+			}
+		});
+
+		// Add the sums of the blocks in order, and measure how far the means moved
+		old_means = means;
+		T max_moved = T();
+		for (uint32_t c = 0; c < k; ++c) {
+			std::array<T, N> sum = std::array<T, N>();
+			T count = T();
+			for (size_t block = 0; block < blocks; ++block) {
+				count += counts[block * k + c];
+				for (size_t j = 0; j < N; ++j) {
+					sum[j] += sums[block * k + c][j];
+				}
+			}
+			if (count != 0) {
+				for (size_t j = 0; j < N; ++j) {
+					means[c][j] = sum[j] / count;
+				}
+			}
+			moved[c] = std::sqrt(details::distance_squared(means[c], old_means[c]));
+			max_moved = std::max(max_moved, moved[c]);
+		}
+
+		if (means == old_means || max_moved <= tolerance)
+			break;
+	}
+
+	return std::tuple<std::vector<std::array<T, N>>, std::vector<uint32_t>>(means, clusters);
+}
+
+} // namespace dkm
+
+#endif /* DKM_HAMERLY_KMEANS_H */
@@ -0,0 +1,235 @@
+#pragma once
+
+// only included in case there's a C++11 compiler out there that doesn't support `#pragma once`
+#ifndef DKM_PARALLEL_KMEANS_H
+#define DKM_PARALLEL_KMEANS_H
+
+#include "dkm.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+/*
+DKM - A k-means implementation that is generic across variable data dimensions.
+
+This file contains a variant of kmeans_lloyd that runs each iteration across a pool of threads.
+*/
+namespace dkm {
+
+namespace details {
+
+/*
+A fixed set of worker threads that run the tasks of one job at a time together with the calling
+thread. The threads take task indices in turn until all tasks of the job are taken.
+*/
+class thread_pool {
+public:
+	explicit thread_pool(size_t threads) {
+		for (size_t i = 1; i < threads; ++i) {
+			workers.emplace_back([this] { work(); });
+		}
+	}
+
+	~thread_pool() {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stop = true;
+		}
+		start.notify_all();
+		for (auto& worker : workers) {
+			worker.join();
+		}
+	}
+
+	size_t size() const { return workers.size() + 1; }
+
+	/*
+	Run task(i) for each i from 0 to count - 1, and return when all of them are done.
+	*/
+	void run(size_t count, const std::function<void(size_t)>& task) {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			job = &task;
+			job_size = count;
+			next = 0;
+			pending = workers.size();
+			++generation;
+		}
+		start.notify_all();
+		take(task, count);
+
+		// every worker takes part in every job, so a worker never takes a task of the next job with the
+		// function of this one
+		std::unique_lock<std::mutex> lock(mutex);
+		done.wait(lock, [this] { return pending == 0; });
+		job = nullptr;
+	}
+
+private:
+	void take(const std::function<void(size_t)>& task, size_t count) {
+		for (size_t i = next++; i < count; i = next++) {
+			task(i);
+		}
+	}
+
+	void work() {
+		uint64_t seen = 0;
+		for (;;) {
+			const std::function<void(size_t)>* task;
+			size_t count;
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				start.wait(lock, [&] { return stop || generation != seen; });
+				if (stop) {
+					return;
+				}
+				seen = generation;
+				task = job;
+				count = job_size;
+			}
+			take(*task, count);
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				if (--pending == 0) {
+					done.notify_all();
+				}
+			}
+		}
+	}
+
+	std::vector<std::thread> workers;
+	std::mutex mutex;
+	std::condition_variable start;
+	std::condition_variable done;
+	const std::function<void(size_t)>* job = nullptr;
+	size_t job_size = 0;
+	std::atomic<size_t> next{0};
+	size_t pending = 0;
+	uint64_t generation = 0;
+	bool stop = false;
+};
+
+/*
+The number of points in each task. The points are summed per block and the blocks are added in
+order, so the results don't depend on the number of threads.
+*/
+constexpr size_t parallel_block_size = 4096;
+
+/*
+The kmeans++ initialization as in random_plusplus, with the distances to the closest mean updated
+for the newest mean only, in parallel. The smallest distance doesn't depend on the order the means
+are compared in, so the means picked are the same as those of random_plusplus for the same seed.
+*/
+template <typename T, size_t N>
+std::vector<std::array<T, N>> random_plusplus_parallel(
+	const std::vector<std::array<T, N>>& data, uint32_t k, uint64_t seed, thread_pool& pool) {
+	assert(k > 0);
+	using input_size_t = typename std::array<T, N>::size_type;
+	std::vector<std::array<T, N>> means;
+	std::linear_congruential_engine<uint64_t, 6364136223846793005, 1442695040888963407, UINT64_MAX> rand_engine(seed);
+
+	// Select first mean at random from the set
+	{
+		std::uniform_int_distribution<input_size_t> uniform_generator(0, data.size() - 1);
+		means.push_back(data[uniform_generator(rand_engine)]);
+	}
+
+	const size_t blocks = (data.size() + parallel_block_size - 1) / parallel_block_size;
+	std::vector<T> distances(data.size());
+	for (uint32_t count = 1; count < k; ++count) {
+		const auto& mean = means.back();
+		pool.run(blocks, [&](size_t block) {
+			size_t end = std::min(data.size(), (block + 1) * parallel_block_size);
+			for (size_t i = block * parallel_block_size; i < end; ++i) {
+				T distance = distance_squared(data[i], mean);
+				if (count == 1 || distance < distances[i])
+					distances[i] = distance;
+			}
+		});
+		// Pick a random point weighted by the distance from existing means
+		std::discrete_distribution<input_size_t> generator(distances.begin(), distances.end());
+		means.push_back(data[generator(rand_engine)]);
+	}
+	return means;
+}
+
+} // namespace details
+
+/*
+A parallel variant of kmeans_lloyd. The data is divided into blocks that the threads of a pool
+assign to their closest means, summing the points of each cluster per block. The sums of the blocks
+are then added in block order to update the means.
+
+The results are the same for the same seed whatever the number of threads, but may differ in the
+last bits of the means from those of kmeans_lloyd, which sums the points in a different order.
+A thread count of 0 uses the number of hardware threads.
+*/
+template <typename T, size_t N>
+std::tuple<std::vector<std::array<T, N>>, std::vector<uint32_t>> kmeans_lloyd_parallel(
+	const std::vector<std::array<T, N>>& data, uint32_t k, uint64_t seed, size_t threads = 0) {
+	static_assert(std::is_arithmetic<T>::value && std::is_signed<T>::value,
+		"kmeans_lloyd_parallel requires the template parameter T to be a signed arithmetic type (e.g. float, double, int)");
+	assert(k > 0); // k must be greater than zero
+	assert(data.size() >= k); // there must be at least k data points
+
+	const size_t blocks = (data.size() + details::parallel_block_size - 1) / details::parallel_block_size;
+	if (threads == 0)
+		threads = std::max(1u, std::thread::hardware_concurrency());
+	details::thread_pool pool(std::min(threads, blocks));
+
+	std::vector<std::array<T, N>> means = details::random_plusplus_parallel(data, k, seed, pool);
+
+	std::vector<std::array<T, N>> old_means;
+	std::vector<uint32_t> clusters(data.size());
+	std::vector<std::array<T, N>> sums(blocks * k);
+	std::vector<T> counts(blocks * k);
+	// Calculate new means until convergence is reached
+	do {
+		// Assign the points to their closest means, and sum the points of each cluster per block
+		pool.run(blocks, [&](size_t block) {
+			std::array<T, N>* block_sums = &sums[block * k];
+			T* block_counts = &counts[block * k];
+			std::fill(block_sums, block_sums + k, std::array<T, N>());
+			std::fill(block_counts, block_counts + k, T());
+			size_t end = std::min(data.size(), (block + 1) * details::parallel_block_size);
+			for (size_t i = block * details::parallel_block_size; i < end; ++i) {
+				uint32_t cluster = details::closest_mean(data[i], means);
+				clusters[i] = cluster;
+				block_counts[cluster] += 1;
+				for (size_t j = 0; j < N; ++j) {
+					block_sums[cluster][j] += data[i][j];
+				}
+			}
+		});
+
+		// Add the sums of the blocks in order
+		old_means = means;
+		for (uint32_t c = 0; c < k; ++c) {
+			std::array<T, N> sum = std::array<T, N>();
+			T count = T();
+			for (size_t block = 0; block < blocks; ++block) {
+				count += counts[block * k + c];
+				for (size_t j = 0; j < N; ++j) {
+					sum[j] += sums[block * k + c][j];
+				}
+			}
+			if (count == 0) {
+				means[c] = old_means[c];
+			} else {
+				for (size_t j = 0; j < N; ++j) {
+					means[c][j] = sum[j] / count;
+				}
+			}
+		}
+	} while (means != old_means);
+
+	return std::tuple<std::vector<std::array<T, N>>, std::vector<uint32_t>>(means, clusters);
+}
+
+} // namespace dkm
+
+#endif /* DKM_PARALLEL_KMEANS_H */
@@ -0,0 +1,199 @@
+#pragma once
+
+// only included in case there's a C++11 compiler out there that doesn't support `#pragma once`
+#ifndef DKM_SOA_KMEANS_H
+#define DKM_SOA_KMEANS_H
+
+#include "dkm_parallel.hpp"
+
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define DKM_SOA_SSE2
+#endif
+
+/*
+DKM - A k-means implementation that is generic across variable data dimensions.
+
+This file contains a variant of kmeans_lloyd_parallel for 3 channel float data such as RGB colors.
+The points and the means are kept as separate planes of each channel (structure of arrays), so the
+distances of a group of points to a mean are computed with SIMD instructions.
+*/
+namespace dkm {
+
+namespace details {
+
+/*
+The number of points whose closest means are searched together.
+*/
+constexpr size_t soa_group_size = 16;
+
+/*
+The channels of the points or the means in separate planes. The planes of the points are padded to
+a multiple of the group size.
+*/
+struct soa_planes {
+	std::vector<float> r, g, b;
+
+	soa_planes(const std::vector<std::array<float, 3>>& data, size_t padding) {
+		size_t size = (data.size() + padding - 1) / padding * padding;
+		r.assign(size, 0.f);
+		g.assign(size, 0.f);
+		b.assign(size, 0.f);
+		for (size_t i = 0; i < data.size(); ++i) {
+			r[i] = data[i][0];
+			g[i] = data[i][1];
+			b[i] = data[i][2];
+		}
+	}
+};
+
+/*
+Calculate the index of the mean each of a group of soa_group_size points is closest to. The distances
+are summed in the order of distance_squared, and the first of equally close means is chosen, so the
+indices are the same as those of closest_mean.
+*/
+inline void closest_means_soa(const float* r, const float* g, const float* b, const soa_planes& means,
+	uint32_t k, uint32_t* clusters) {
+#ifdef DKM_SOA_SSE2
+	const size_t vectors = soa_group_size / 4;
+	__m128 pr[vectors], pg[vectors], pb[vectors], best[vectors];
+	__m128i index[vectors];
+	for (size_t v = 0; v < vectors; ++v) {
+		pr[v] = _mm_loadu_ps(r + 4 * v);
+		pg[v] = _mm_loadu_ps(g + 4 * v);
+		pb[v] = _mm_loadu_ps(b + 4 * v);
+	}
+
+	for (uint32_t c = 0; c < k; ++c) {
+		const __m128 mr = _mm_set1_ps(means.r[c]);
+		const __m128 mg = _mm_set1_ps(means.g[c]);
+		const __m128 mb = _mm_set1_ps(means.b[c]);
+		const __m128i mean = _mm_set1_epi32(int(c));
+		for (size_t v = 0; v < vectors; ++v) {
+			__m128 dr = _mm_sub_ps(pr[v], mr);
+			__m128 dg = _mm_sub_ps(pg[v], mg);
+			__m128 db = _mm_sub_ps(pb[v], mb);
+			__m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dr, dr), _mm_mul_ps(dg, dg)), _mm_mul_ps(db, db));
+			if (c == 0) {
+				best[v] = distance;
+				index[v] = mean;
+			} else {
+				__m128i closer = _mm_castps_si128(_mm_cmplt_ps(distance, best[v]));
+				best[v] = _mm_min_ps(distance, best[v]);
+				index[v] = _mm_or_si128(_mm_and_si128(closer, mean), _mm_andnot_si128(closer, index[v]));
+			}
+		}
+	}
+
+	for (size_t v = 0; v < vectors; ++v) {
+		_mm_storeu_si128((__m128i*)(clusters + 4 * v), index[v]);
+	}
+#else
+	float best[soa_group_size];
+	for (size_t i = 0; i < soa_group_size; ++i) {
+		clusters[i] = 0;
+	}
+	for (uint32_t c = 0; c < k; ++c) {
+		const float mr = means.r[c], mg = means.g[c], mb = means.b[c];
+		for (size_t i = 0; i < soa_group_size; ++i) {
+			float dr = r[i] - mr, dg = g[i] - mg, db = b[i] - mb;
+			float distance = dr * dr + dg * dg + db * db;
+			if (c == 0 || distance < best[i]) {
+				best[i] = distance;
+				clusters[i] = c;
+			}
+		}
+	}
+#endif
+}
+
+} // namespace details
+
+/*
+A variant of kmeans_lloyd_parallel for 3 channel float data. The means are initialized and updated
+as in kmeans_lloyd_parallel, and the points are summed in the same order, so the results are the
+same as those of kmeans_lloyd_parallel for the same seed.
+
+The iterations stop as in kmeans_hamerly: when no mean moves further than the tolerance, or after
+max_iterations iterations if it is not 0. With the defaults the iterations stop when the means no
+longer change.
+*/
+inline std::tuple<std::vector<std::array<float, 3>>, std::vector<uint32_t>> kmeans_lloyd_soa(
+	const std::vector<std::array<float, 3>>& data, uint32_t k, uint64_t seed, float tolerance = 0.f,
+	uint32_t max_iterations = 0, size_t threads = 0) {
+	assert(k > 0); // k must be greater than zero
+	assert(data.size() >= k); // there must be at least k data points
+	static_assert(details::parallel_block_size % details::soa_group_size == 0,
+		"the blocks must hold whole groups of points");
+
+	const size_t blocks = (data.size() + details::parallel_block_size - 1) / details::parallel_block_size;
+	if (threads == 0)
+		threads = std::max(1u, std::thread::hardware_concurrency());
+	details::thread_pool pool(std::min(threads, blocks));
+
+	std::vector<std::array<float, 3>> means = details::random_plusplus_parallel(data, k, seed, pool);
+
+	const details::soa_planes points(data, details::soa_group_size);
+	std::vector<std::array<float, 3>> old_means;
+	std::vector<uint32_t> clusters(points.r.size());
+	std::vector<std::array<float, 3>> sums(blocks * k);
+	std::vector<float> counts(blocks * k);
+	// Calculate new means until convergence is reached
+	for (uint32_t iteration = 0; max_iterations == 0 || iteration < max_iterations; ++iteration) {
+		const details::soa_planes mean_planes(means, 1);
+
+		// Assign the points to their closest means, and sum the points of each cluster per block
+		pool.run(blocks, [&](size_t block) {
+			std::array<float, 3>* block_sums = &sums[block * k];
+			float* block_counts = &counts[block * k];
+			std::fill(block_sums, block_sums + k, std::array<float, 3>());
+			std::fill(block_counts, block_counts + k, 0.f);
+			size_t begin = block * details::parallel_block_size;
+			size_t end = std::min(data.size(), begin + details::parallel_block_size);
+			for (size_t i = begin; i < end; i += details::soa_group_size) {
+				details::closest_means_soa(&points.r[i], &points.g[i], &points.b[i], mean_planes, k, &clusters[i]);
+			}
+			for (size_t i = begin; i < end; ++i) {
+				uint32_t cluster = clusters[i];
+				block_counts[cluster] += 1;
+				block_sums[cluster][0] += points.r[i];
+				block_sums[cluster][1] += points.g[i];
+				block_sums[cluster][2] += points.b[i];
+			}
+		});
+
+		// Add the sums of the blocks in order, and measure how far the means moved
+		old_means = means;
+		float max_moved = 0.f;
+		for (uint32_t c = 0; c < k; ++c) {
+			std::array<float, 3> sum = std::array<float, 3>();
+			float count = 0.f;
+			for (size_t block = 0; block < blocks; ++block) {
+				count += counts[block * k + c];
+				for (size_t j = 0; j < 3; ++j) {
+					sum[j] += sums[block * k + c][j];
+				}
+			}
+			if (count == 0) {
+				means[c] = old_means[c];
+			} else {
+				for (size_t j = 0; j < 3; ++j) {
+					means[c][j] = sum[j] / count;
+				}
+			}
+			max_moved = std::max(max_moved, std::sqrt(details::distance_squared(means[c], old_means[c])));
+		}
+
+		if (means == old_means || max_moved <= tolerance)
+			break;
+	}
+
+	clusters.resize(data.size());
+	return std::tuple<std::vector<std::array<float, 3>>, std::vector<uint32_t>>(means, clusters);
+}
+
+} // namespace dkm
+
+#endif /* DKM_SOA_KMEANS_H */
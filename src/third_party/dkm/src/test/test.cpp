@@ -7,6 +7,9 @@ This is just simple test harness without any external dependencies.
 */
 
 #include "../../include/dkm.hpp"
+#include "../../include/dkm_parallel.hpp"
+#include "../../include/dkm_soa.hpp"
+#include "../../include/dkm_hamerly.hpp"
 #include "lest.hpp"
 
 #include <vector>
@@ -19,6 +22,38 @@ This is just simple test harness without any external dependencies.
 #pragma clang diagnostic ignored "-Wmissing-braces"
 #endif
 
+namespace {
+
+using random_engine = std::linear_congruential_engine<uint64_t, 6364136223846793005, 1442695040888963407, UINT64_MAX>;
+
+/*
+A dataset of count points, where point(engine, i) makes the i-th point from an engine seeded with seed.
+*/
+template <typename Point>
+std::vector<std::array<float, 3>> random_dataset(uint64_t seed, int count, Point point) {
+	std::vector<std::array<float, 3>> data;
+	random_engine engine(seed);
+	for (int i = 0; i < count; ++i) {
+		data.push_back(point(engine, i));
+	}
+	return data;
+}
+
+/*
+A dataset of count colors with channels uniformly distributed from 0 to max_channel.
+*/
+std::vector<std::array<float, 3>> random_colors(uint64_t seed, int count, int max_channel) {
+	std::uniform_int_distribution<int> channel(0, max_channel);
+	return random_dataset(seed, count, [&](random_engine& engine, int) {
+		float r = float(channel(engine));
+		float g = float(channel(engine));
+		float b = float(channel(engine));
+		return std::array<float, 3>{{r, g, b}};
+	});
+}
+
+} // namespace
+
 const lest::test specification[] = {
 	CASE("Small 2D dataset is successfully segmented into 3 clusters",) {
 		SETUP("Small 2D dataset") {
@@ -67,6 +102,117 @@ const lest::test specification[] = {
 			}
 		}
 	},
+	CASE("Parallel k-means matches the serial k-means for the same seed",) {
+		SETUP("Large 3D dataset") {
+			// points spread around 8 corners, more than one block per thread
+			std::uniform_int_distribution<int> noise(-20, 20);
+			auto data = random_dataset(7, 50000, [&](random_engine& engine, int i) {
+				float r = float((i & 1) * 200 + noise(engine));
+				float g = float(((i >> 1) & 1) * 200 + noise(engine));
+				float b = float(((i >> 2) & 1) * 200 + noise(engine));
+				return std::array<float, 3>{{r, g, b}};
+			});
+			uint32_t k = 8;
+
+			SECTION("Initial means are the same as the serial kmeans++") {
+				dkm::details::thread_pool pool(4);
+				auto serial = dkm::details::random_plusplus(data, k, 42);
+				auto parallel = dkm::details::random_plusplus_parallel(data, k, 42, pool);
+				EXPECT(serial == parallel);
+			}
+
+			SECTION("Results don't depend on the number of threads") {
+				auto one = dkm::kmeans_lloyd_parallel(data, k, 42, 1);
+				auto four = dkm::kmeans_lloyd_parallel(data, k, 42, 4);
+				EXPECT(std::get<0>(one) == std::get<0>(four));
+				EXPECT(std::get<1>(one) == std::get<1>(four));
+			}
+
+			SECTION("Clusters are the same as those of the serial k-means") {
+				auto serial = dkm::kmeans_lloyd(data, k, 42);
+				auto parallel = dkm::kmeans_lloyd_parallel(data, k, 42, 4);
+				EXPECT(std::get<1>(serial) == std::get<1>(parallel));
+				for (uint32_t c = 0; c < k; ++c) {
+					for (size_t j = 0; j < 3; ++j) {
+						EXPECT(std::get<0>(serial)[c][j] == lest::approx(std::get<0>(parallel)[c][j]));
+					}
+				}
+			}
+		}
+	},
+	CASE("Structure of arrays k-means matches the parallel k-means",) {
+		SETUP("Color dataset that doesn't fill the last group of points") {
+			auto data = random_colors(11, 30011, 255);
+
+			SECTION("Closest means are the same as those of closest_mean") {
+				std::vector<std::array<float, 3>> means(data.begin(), data.begin() + 37);
+				dkm::details::soa_planes points(data, dkm::details::soa_group_size);
+				dkm::details::soa_planes mean_planes(means, 1);
+				uint32_t clusters[dkm::details::soa_group_size];
+				bool same = true;
+				for (size_t i = 0; i + dkm::details::soa_group_size <= data.size(); i += dkm::details::soa_group_size) {
+					dkm::details::closest_means_soa(&points.r[i], &points.g[i], &points.b[i], mean_planes, 37, clusters);
+					for (size_t j = 0; j < dkm::details::soa_group_size; ++j) {
+						same = same && clusters[j] == dkm::details::closest_mean(data[i + j], means);
+					}
+				}
+				EXPECT(same);
+			}
+
+			SECTION("Means and clusters are the same for the same seed") {
+				auto parallel = dkm::kmeans_lloyd_parallel(data, 16, 3, 4);
+				auto soa = dkm::kmeans_lloyd_soa(data, 16, 3, 0.f, 0, 4);
+				EXPECT(std::get<0>(parallel) == std::get<0>(soa));
+				EXPECT(std::get<1>(parallel) == std::get<1>(soa));
+			}
+		}
+	},
+	CASE("Hamerly's k-means matches the parallel k-means",) {
+		SETUP("Color dataset with many equally close means") {
+			auto data = random_colors(13, 20000, 63);
+
+			SECTION("Closest and second closest means are found") {
+				std::vector<std::array<float, 3>> means(data.begin(), data.begin() + 29);
+				dkm::details::mean_planes<float, 3> planes;
+				planes.assign(means);
+				bool same = true;
+				for (auto& point : data) {
+					dkm::details::hamerly_bounds<float> bounds;
+					uint32_t cluster = dkm::details::closest_means_bounded(point, planes, 29, bounds);
+					std::vector<float> distances;
+					for (auto& mean : means) {
+						distances.push_back(dkm::details::distance_squared(point, mean));
+					}
+					std::sort(distances.begin(), distances.end());
+					same = same && cluster == dkm::details::closest_mean(point, means);
+					same = same && bounds.upper == std::sqrt(distances[0]) && bounds.lower == std::sqrt(distances[1]);
+				}
+				EXPECT(same);
+			}
+
+			SECTION("Means and clusters are the same for the same seed") {
+				auto parallel = dkm::kmeans_lloyd_parallel(data, 48, 5, 2);
+				auto hamerly = dkm::kmeans_hamerly(data, 48, 5, 0.f, 0, 2);
+				EXPECT(std::get<0>(parallel) == std::get<0>(hamerly));
+				EXPECT(std::get<1>(parallel) == std::get<1>(hamerly));
+			}
+
+			SECTION("Iterations stop at the iteration cap") {
+				dkm::details::thread_pool pool(1);
+				auto means = dkm::details::random_plusplus_parallel(data, 48, 5, pool);
+				auto hamerly = dkm::kmeans_hamerly(data, 48, 5, 0.f, 1, 2);
+				EXPECT(std::get<1>(hamerly) == dkm::details::calculate_clusters(data, means));
+			}
+
+			SECTION("Iterations stop when the means move less than the tolerance") {
+				auto exact = dkm::kmeans_hamerly(data, 48, 5);
+				auto tolerant = dkm::kmeans_hamerly(data, 48, 5, 0.5f);
+				for (uint32_t c = 0; c < 48; ++c) {
+					EXPECT(std::sqrt(dkm::details::distance_squared(std::get<0>(exact)[c], std::get<0>(tolerant)[c])) < 8.f);
+				}
+			}
+		}
+	},
 };
 
 int main(int argc, char** argv) {